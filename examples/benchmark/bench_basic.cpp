@@ -8,10 +8,14 @@
  * - Float logging
  * - Multiple arguments
  * - Different log levels
+ *
+ * Usage: bench_basic [--json results.json]
  */
 
 #include <echo/echo.hpp>
 
+#include "perf_counters.hpp"
+
 #include <chrono>
 #include <iomanip>
 #include <iostream>
@@ -27,6 +31,7 @@ struct BenchResult {
     double max_ns;
     size_t iterations;
     double ops_per_sec;
+    bench::PerfSample perf; // per call
 };
 
 template <typename Func> BenchResult benchmark(const std::string &name, Func func, size_t iterations = 100000) {
@@ -61,7 +66,10 @@ template <typename Func> BenchResult benchmark(const std::string &name, Func fun
 
     double avg = sum / iterations;
 
-    return {name, avg, min_val, max_val, iterations, 1e9 / avg};
+    // Counters are taken in a separate untimed pass, so clock reads do not show up in them
+    bench::PerfSample perf = bench::measure_counters(func, iterations);
+
+    return {name, avg, min_val, max_val, iterations, 1e9 / avg, perf};
 }
 
 void print_result(const BenchResult &r) {
@@ -70,7 +78,7 @@ void print_result(const BenchResult &r) {
               << r.max_ns << " ns | " << std::setw(12) << std::setprecision(0) << r.ops_per_sec << " ops/s\n";
 }
 
-int main() {
+int main(int argc, char **argv) {
     std::cout << "\n=== BASIC LOGGING BENCHMARKS ===\n\n";
 
     // Disable output for fair benchmarking
@@ -128,5 +136,11 @@ int main() {
 
     std::cout << "\nNote: All benchmarks run with sinks disabled (null output)\n";
 
-    return 0;
+    bench::Report report("basic", argc, argv);
+    for (const auto &r : results) {
+        report.add(r.name,
+                   {{"avg_ns", r.avg_ns}, {"min_ns", r.min_ns}, {"max_ns", r.max_ns}, {"ops_per_sec", r.ops_per_sec}},
+                   r.perf);
+    }
+    return report.finish(40);
 }
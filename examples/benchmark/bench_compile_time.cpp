@@ -6,6 +6,8 @@
  * - Compile-time log level filtering (LOGLEVEL macro)
  * - Runtime log level filtering
  * - No filtering
+ *
+ * Usage: bench_compile_time [--json results.json]
  */
 
 #include <echo/core/level.hpp>
@@ -13,6 +15,8 @@
 #include <echo/sinks/null_sink.hpp>
 #include <echo/sinks/registry.hpp>
 
+#include "perf_counters.hpp"
+
 #include <chrono>
 #include <iomanip>
 #include <iostream>
@@ -28,6 +32,7 @@ struct BenchResult {
     double max_ns;
     size_t iterations;
     double ops_per_sec;
+    bench::PerfSample perf; // per call
 };
 
 template <typename Func> BenchResult benchmark(const std::string &name, Func func, size_t iterations = 100000) {
@@ -62,7 +67,10 @@ template <typename Func> BenchResult benchmark(const std::string &name, Func fun
 
     double avg = sum / iterations;
 
-    return {name, avg, min_val, max_val, iterations, 1e9 / avg};
+    // Counters are taken in a separate untimed pass, so clock reads do not show up in them
+    bench::PerfSample perf = bench::measure_counters(func, iterations);
+
+    return {name, avg, min_val, max_val, iterations, 1e9 / avg, perf};
 }
 
 void print_result(const BenchResult &r) {
@@ -71,7 +79,7 @@ void print_result(const BenchResult &r) {
               << r.max_ns << " ns | " << std::setw(12) << std::setprecision(0) << r.ops_per_sec << " ops/s\n";
 }
 
-int main() {
+int main(int argc, char **argv) {
     std::cout << "\n=== COMPILE-TIME vs RUNTIME FILTERING BENCHMARKS ===\n\n";
 
     // Use null sink for fair benchmarking
@@ -135,5 +143,11 @@ int main() {
     std::cout << "Rebuild with -DLOGLEVEL=Error to test compile-time filtering\n";
 #endif
 
-    return 0;
+    bench::Report report("compile_time", argc, argv);
+    for (const auto &r : results) {
+        report.add(r.name,
+                   {{"avg_ns", r.avg_ns}, {"min_ns", r.min_ns}, {"max_ns", r.max_ns}, {"ops_per_sec", r.ops_per_sec}},
+                   r.perf);
+    }
+    return report.finish(50);
 }
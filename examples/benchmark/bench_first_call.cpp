@@ -0,0 +1,209 @@
+/**
+ * @file bench_first_call.cpp
+ * @brief First-call vs steady-state latency benchmarks
+ *
+ * Measures the one-time cost paid by the first log call:
+ * - First call in a process (cold vs after echo::warm_up())
+ * - First call on a new thread (cold vs after echo::thread_warm_up())
+ * - Steady-state latency for comparison
+ *
+ * Process-level numbers are taken in forked children, so every trial starts
+ * from a process in which echo has never been used. Counters are opened in the
+ * child or the new thread, so they count only the measured calls.
+ *
+ * Usage: bench_first_call [--json results.json]
+ */
+
+#define ECHO_ENABLE_NULL_SINK
+#include <echo/echo.hpp>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "perf_counters.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+struct FirstCallResult {
+    std::string name;
+    double first_ns;  // median first-call latency over trials
+    double steady_ns; // median steady-state latency
+    bench::PerfSample first_perf;
+    bench::PerfSample steady_perf; // per call
+};
+
+/// Latency of the first and of the following calls, measured in one process/thread
+struct Sample {
+    double first_ns;
+    double steady_ns;
+    bench::PerfSample first_perf;
+    bench::PerfSample steady_perf;
+};
+
+template <typename Func> double time_once(Func func) {
+    auto start = high_resolution_clock::now();
+    func();
+    auto end = high_resolution_clock::now();
+    return static_cast<double>(duration_cast<nanoseconds>(end - start).count());
+}
+
+Sample measure_calls(size_t steady_iterations = 1000) {
+    Sample s{};
+    bench::PerfCounters perf; // Opened after fork() / on the new thread: counts this thread only
+    perf.start();
+    s.first_ns = time_once([] { echo::info("order ", 42, " filled at ", 101.25).every(0); });
+    perf.stop();
+    s.first_perf = perf.sample(1);
+
+    std::vector<double> times;
+    times.reserve(steady_iterations);
+    for (size_t i = 0; i < steady_iterations; ++i) {
+        times.push_back(time_once([i] { echo::info("order ", i, " filled at ", 101.25).every(0); }));
+    }
+    std::sort(times.begin(), times.end());
+    s.steady_ns = times[times.size() / 2];
+
+    // Steady-state counters in a separate untimed pass
+    size_t i = 0;
+    s.steady_perf = bench::measure_counters(
+        perf, [&i] { echo::info("order ", i++, " filled at ", 101.25).every(0); }, steady_iterations);
+    return s;
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+/// Per-counter median over the trials that have the counter
+bench::PerfSample median(const std::vector<bench::PerfSample> &samples) {
+    bench::PerfSample m;
+    for (size_t c = 0; c < bench::COUNTER_COUNT; ++c) {
+        std::vector<double> values;
+        for (const auto &s : samples) {
+            if (s.values[c]) {
+                values.push_back(*s.values[c]);
+            }
+        }
+        if (!values.empty()) {
+            m.values[c] = median(values);
+        }
+    }
+    return m;
+}
+
+/// Run the setup + measurement in a fresh forked child, return its sample
+template <typename Setup> Sample sample_in_child(Setup setup) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return {};
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        setup();
+        Sample s = measure_calls();
+        ssize_t written = write(fds[1], &s, sizeof(s));
+        (void)written;
+        close(fds[1]);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    Sample s{};
+    ssize_t got = read(fds[0], &s, sizeof(s));
+    (void)got;
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return s;
+}
+
+template <typename Setup> FirstCallResult process_benchmark(const std::string &name, Setup setup, int trials = 25) {
+    std::vector<double> first, steady;
+    std::vector<bench::PerfSample> first_perf, steady_perf;
+    for (int i = 0; i < trials; ++i) {
+        Sample s = sample_in_child(setup);
+        first.push_back(s.first_ns);
+        steady.push_back(s.steady_ns);
+        first_perf.push_back(s.first_perf);
+        steady_perf.push_back(s.steady_perf);
+    }
+    return {name, median(first), median(steady), median(first_perf), median(steady_perf)};
+}
+
+template <typename Setup> FirstCallResult thread_benchmark(const std::string &name, Setup setup, int trials = 25) {
+    std::vector<double> first, steady;
+    std::vector<bench::PerfSample> first_perf, steady_perf;
+    for (int i = 0; i < trials; ++i) {
+        Sample s{};
+        std::thread worker([&] {
+            setup();
+            s = measure_calls();
+        });
+        worker.join();
+        first.push_back(s.first_ns);
+        steady.push_back(s.steady_ns);
+        first_perf.push_back(s.first_perf);
+        steady_perf.push_back(s.steady_perf);
+    }
+    return {name, median(first), median(steady), median(first_perf), median(steady_perf)};
+}
+
+void print_result(const FirstCallResult &r) {
+    std::cout << std::left << std::setw(40) << r.name << " | " << std::right << std::setw(12) << std::fixed
+              << std::setprecision(1) << r.first_ns << " | " << std::setw(12) << r.steady_ns << " | " << std::setw(8)
+              << std::setprecision(1) << (r.steady_ns > 0 ? r.first_ns / r.steady_ns : 0.0) << "x\n";
+}
+
+int main(int argc, char **argv) {
+    std::cout << "\n=== FIRST-CALL LATENCY BENCHMARKS ===\n\n";
+
+    auto use_null_sink = [] {
+        echo::clear_sinks();
+        echo::add_sink(std::make_shared<echo::NullSink>());
+    };
+
+    std::vector<FirstCallResult> results;
+
+    // Process-level (forked children: echo untouched before setup)
+    results.push_back(process_benchmark("Process: cold", use_null_sink));
+    results.push_back(process_benchmark("Process: after warm_up()", [&] {
+        use_null_sink();
+        echo::warm_up();
+    }));
+
+    // Thread-level (process already warm, new thread each trial)
+    use_null_sink();
+    echo::warm_up();
+    results.push_back(thread_benchmark("Thread: cold", [] {}));
+    results.push_back(thread_benchmark("Thread: after thread_warm_up()", [] { echo::thread_warm_up(); }));
+
+    std::cout << std::left << std::setw(40) << "Benchmark"
+              << " | " << std::setw(12) << "First (ns)"
+              << " | " << std::setw(12) << "Steady (ns)"
+              << " | " << "Ratio\n";
+    std::cout << std::string(85, '-') << "\n";
+
+    for (const auto &r : results) {
+        print_result(r);
+    }
+
+    std::cout << "\nNote: medians over 25 trials; steady = median of the 1000 calls after the first\n";
+    std::cout << "All benchmarks use NullSink to isolate logging overhead\n";
+
+    bench::Report report("first_call", argc, argv);
+    for (const auto &r : results) {
+        report.add(r.name + " (first)", {{"first_ns", r.first_ns}}, r.first_perf);
+        report.add(r.name + " (steady)", {{"steady_ns", r.steady_ns}}, r.steady_perf);
+    }
+    return report.finish(40);
+}
@@ -8,6 +8,10 @@
  * - P50, P95, P99, P99.9 percentiles
  * - Maximum latency
  * - Latency distribution
+ * - Per-call hardware counters (cycles, IPC, cache/branch misses, context
+ *   switches) where perf_event_open is available, see perf_counters.hpp
+ *
+ * Usage: bench_latency [--json results.json]
  */
 
 #include <echo/core/level.hpp>
@@ -15,6 +19,8 @@
 #include <echo/sinks/null_sink.hpp>
 #include <echo/sinks/registry.hpp>
 
+#include "perf_counters.hpp"
+
 #include <algorithm>
 #include <chrono>
 #include <iomanip>
@@ -33,6 +39,7 @@ struct LatencyResult {
     double p999_ns;
     double max_ns;
     double avg_ns;
+    bench::PerfSample perf; // per call
 };
 
 template <typename Func> LatencyResult measure_latency(const std::string &name, Func func, size_t iterations = 100000) {
@@ -62,6 +69,9 @@ template <typename Func> LatencyResult measure_latency(const std::string &name,
     }
     double avg = sum / iterations;
 
+    // Counters are taken in a separate untimed pass, so clock reads do not show up in them
+    bench::PerfSample perf = bench::measure_counters(func, iterations);
+
     size_t p50_idx = iterations * 50 / 100;
     size_t p95_idx = iterations * 95 / 100;
     size_t p99_idx = iterations * 99 / 100;
@@ -75,7 +85,8 @@ template <typename Func> LatencyResult measure_latency(const std::string &name,
         times[p99_idx],        // p99
         times[p999_idx],       // p99.9
         times[iterations - 1], // max
-        avg                    // average
+        avg,                   // average
+        perf                   // counters per call
     };
 }
 
@@ -86,7 +97,7 @@ void print_result(const LatencyResult &r) {
               << std::setw(8) << r.max_ns << " | " << std::setw(8) << r.avg_ns << "\n";
 }
 
-int main() {
+int main(int argc, char **argv) {
     std::cout << "\n=== LATENCY PERCENTILE BENCHMARKS ===\n\n";
 
     // Use null sink for fair benchmarking
@@ -145,5 +156,17 @@ int main() {
     std::cout << "P50 = median, P95/P99/P99.9 = tail latencies\n";
     std::cout << "All benchmarks use NullSink to isolate logging overhead\n";
 
-    return 0;
+    bench::Report report("latency", argc, argv);
+    for (const auto &r : results) {
+        report.add(r.name,
+                   {{"min_ns", r.min_ns},
+                    {"p50_ns", r.p50_ns},
+                    {"p95_ns", r.p95_ns},
+                    {"p99_ns", r.p99_ns},
+                    {"p999_ns", r.p999_ns},
+                    {"max_ns", r.max_ns},
+                    {"avg_ns", r.avg_ns}},
+                   r.perf);
+    }
+    return report.finish(35);
 }
@@ -7,6 +7,8 @@
  * - Subsequent call overhead (hash map lookup)
  * - Comparison with regular logging
  * - Multiple unique .once() calls
+ *
+ * Usage: bench_once [--json results.json]
  */
 
 #include <echo/core/level.hpp>
@@ -14,6 +16,8 @@
 #include <echo/sinks/null_sink.hpp>
 #include <echo/sinks/registry.hpp>
 
+#include "perf_counters.hpp"
+
 #include <chrono>
 #include <iomanip>
 #include <iostream>
@@ -29,6 +33,7 @@ struct BenchResult {
     double max_ns;
     size_t iterations;
     double ops_per_sec;
+    bench::PerfSample perf; // per call
 };
 
 template <typename Func> BenchResult benchmark(const std::string &name, Func func, size_t iterations = 100000) {
@@ -63,7 +68,10 @@ template <typename Func> BenchResult benchmark(const std::string &name, Func fun
 
     double avg = sum / iterations;
 
-    return {name, avg, min_val, max_val, iterations, 1e9 / avg};
+    // Counters are taken in a separate untimed pass, so clock reads do not show up in them
+    bench::PerfSample perf = bench::measure_counters(func, iterations);
+
+    return {name, avg, min_val, max_val, iterations, 1e9 / avg, perf};
 }
 
 void print_result(const BenchResult &r) {
@@ -72,7 +80,7 @@ void print_result(const BenchResult &r) {
               << r.max_ns << " ns | " << std::setw(12) << std::setprecision(0) << r.ops_per_sec << " ops/s\n";
 }
 
-int main() {
+int main(int argc, char **argv) {
     std::cout << "\n=== .once() MODIFIER BENCHMARKS ===\n\n";
 
     // Use null sink for fair benchmarking
@@ -159,5 +167,11 @@ int main() {
     std::cout << "First call per location is slower (hash map insert)\n";
     std::cout << "All benchmarks use NullSink to isolate .once() overhead\n";
 
-    return 0;
+    bench::Report report("once", argc, argv);
+    for (const auto &r : results) {
+        report.add(r.name,
+                   {{"avg_ns", r.avg_ns}, {"min_ns", r.min_ns}, {"max_ns", r.max_ns}, {"ops_per_sec", r.ops_per_sec}},
+                   r.perf);
+    }
+    return report.finish(45);
 }
@@ -7,6 +7,8 @@
  * - Console sink
  * - File sink
  * - Multiple sinks
+ *
+ * Usage: bench_sinks [--json results.json]
  */
 
 #include <echo/core/level.hpp>
@@ -16,6 +18,8 @@
 #include <echo/sinks/null_sink.hpp>
 #include <echo/sinks/registry.hpp>
 
+#include "perf_counters.hpp"
+
 #include <chrono>
 #include <fstream>
 #include <iomanip>
@@ -32,6 +36,7 @@ struct BenchResult {
     double max_ns;
     size_t iterations;
     double ops_per_sec;
+    bench::PerfSample perf; // per call
 };
 
 template <typename Func> BenchResult benchmark(const std::string &name, Func func, size_t iterations = 10000) {
@@ -66,7 +71,10 @@ template <typename Func> BenchResult benchmark(const std::string &name, Func fun
 
     double avg = sum / iterations;
 
-    return {name, avg, min_val, max_val, iterations, 1e9 / avg};
+    // Counters are taken in a separate untimed pass, so clock reads do not show up in them
+    bench::PerfSample perf = bench::measure_counters(func, iterations);
+
+    return {name, avg, min_val, max_val, iterations, 1e9 / avg, perf};
 }
 
 void print_result(const BenchResult &r) {
@@ -75,7 +83,7 @@ void print_result(const BenchResult &r) {
               << r.max_ns << " ns | " << std::setw(12) << std::setprecision(0) << r.ops_per_sec << " ops/s\n";
 }
 
-int main() {
+int main(int argc, char **argv) {
     std::cout << "\n=== SINK PERFORMANCE BENCHMARKS ===\n\n";
 
     std::vector<BenchResult> results;
@@ -134,5 +142,11 @@ int main() {
     std::remove("/tmp/bench_echo2.log");
     std::remove("/tmp/bench_echo3.log");
 
-    return 0;
+    bench::Report report("sinks", argc, argv);
+    for (const auto &r : results) {
+        report.add(r.name,
+                   {{"avg_ns", r.avg_ns}, {"min_ns", r.min_ns}, {"max_ns", r.max_ns}, {"ops_per_sec", r.ops_per_sec}},
+                   r.perf);
+    }
+    return report.finish(40);
 }
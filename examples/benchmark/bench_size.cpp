@@ -0,0 +1,174 @@
+/**
+ * @file bench_size.cpp
+ * @brief Flash/RAM footprint of the full and freestanding profiles
+ *
+ * Compiles three small programs with the host compiler and reports their
+ * section sizes (as printed by `size`):
+ * - baseline: a program that writes one line without echo
+ * - full profile: two log calls through echo.hpp
+ * - freestanding profile: the same calls with -DECHO_FREESTANDING,
+ *   -fno-exceptions and -fno-rtti
+ *
+ * text approximates flash, data + bss approximates static RAM. Numbers for the
+ * object file show echo's own contribution; numbers for the linked binary
+ * include what it pulls in from the C++ runtime (most visible with --static).
+ *
+ * No log call runs here, so there are no counters; --json only records the sizes.
+ *
+ * Usage: bench_size [--static] [--include <dir>] [--json results.json]   (CXX selects the compiler)
+ */
+
+#include "perf_counters.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Sizes {
+    long text = -1;
+    long data = -1;
+    long bss = -1;
+};
+
+struct SizeResult {
+    std::string name;
+    Sizes object;
+    Sizes binary;
+};
+
+struct Variant {
+    std::string name;
+    std::string source;
+    std::string flags;
+};
+
+std::string run(const std::string &command) {
+    std::string output;
+    FILE *pipe = popen(command.c_str(), "r");
+    if (!pipe) {
+        return output;
+    }
+    char buffer[512];
+    while (fgets(buffer, sizeof(buffer), pipe)) {
+        output += buffer;
+    }
+    pclose(pipe);
+    return output;
+}
+
+/// Parse the second line of Berkeley-format `size` output: text data bss dec hex name
+Sizes read_sizes(const std::string &file) {
+    Sizes s;
+    std::istringstream in(run("size " + file + " 2>/dev/null"));
+    std::string header;
+    std::getline(in, header);
+    in >> s.text >> s.data >> s.bss;
+    return s;
+}
+
+SizeResult measure(const Variant &v, const std::string &cxx, const std::string &include, bool link_static) {
+    const std::string base = "/tmp/echo_bench_size_" + std::to_string(std::hash<std::string>{}(v.name));
+    std::ofstream(base + ".cpp") << v.source;
+
+    const std::string common = cxx + " -std=c++20 -Os -ffunction-sections -fdata-sections -I" + include + " " +
+                               v.flags + " " + base + ".cpp";
+    SizeResult r{v.name, {}, {}};
+    if (std::system((common + " -c -o " + base + ".o").c_str()) == 0) {
+        r.object = read_sizes(base + ".o");
+    }
+    std::string link = common + " -Wl,--gc-sections -s -o " + base + ".bin" + (link_static ? " -static" : "");
+    if (std::system(link.c_str()) == 0) {
+        r.binary = read_sizes(base + ".bin");
+    }
+    std::remove((base + ".cpp").c_str());
+    std::remove((base + ".o").c_str());
+    std::remove((base + ".bin").c_str());
+    return r;
+}
+
+std::string cell(long v) { return v < 0 ? "n/a" : std::to_string(v); }
+
+void print_result(const SizeResult &r, const SizeResult &baseline) {
+    std::cout << std::left << std::setw(28) << r.name << std::right;
+    for (const Sizes *s : {&r.object, &r.binary}) {
+        std::cout << " | " << std::setw(8) << cell(s->text) << " | " << std::setw(8)
+                  << cell(s->data < 0 ? -1 : s->data + s->bss);
+    }
+    long delta = (r.binary.text < 0 || baseline.binary.text < 0) ? -1 : r.binary.text - baseline.binary.text;
+    std::cout << " | " << std::setw(10) << cell(delta) << "\n";
+}
+
+int main(int argc, char **argv) {
+    bool link_static = false;
+    std::string include = "include";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--static") {
+            link_static = true;
+        } else if (arg == "--include" && i + 1 < argc) {
+            include = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            ++i; // Read by bench::Report
+        }
+    }
+    const char *env_cxx = std::getenv("CXX");
+    const std::string cxx = env_cxx ? env_cxx : "g++";
+
+    const std::string calls = R"(
+    echo::info("value ", argc, " ratio ", 0.5 * argc);
+    echo::warn("done");
+    return 0;
+}
+)";
+
+    std::vector<Variant> variants = {
+        {"Baseline (no echo)",
+         "#include <unistd.h>\nint main(int argc, char **) { (void)!::write(1, \"x\\n\", 2); return argc - 1; }\n",
+         ""},
+        {"Full profile", "#include <echo/echo.hpp>\nint main(int argc, char **) {" + calls, ""},
+        {"Freestanding profile",
+         "#define ECHO_FREESTANDING\n#include <echo/echo.hpp>\n#include <unistd.h>\n"
+         "static void out(echo::Level, const char *d, size_t n, void *) { (void)!::write(1, d, n); }\n"
+         "int main(int argc, char **) {\n    echo::set_write_callback(out);" +
+             calls,
+         "-fno-exceptions -fno-rtti -fno-threadsafe-statics"},
+    };
+
+    std::cout << "\n=== FOOTPRINT BENCHMARK (" << cxx << ", -Os" << (link_static ? ", static" : ", dynamic")
+              << ") ===\n\n";
+
+    std::vector<SizeResult> results;
+    for (const auto &v : variants) {
+        results.push_back(measure(v, cxx, include, link_static));
+    }
+
+    std::cout << std::left << std::setw(28) << "Program"
+              << " | " << std::setw(8) << "Obj text"
+              << " | " << std::setw(8) << "Obj RAM"
+              << " | " << std::setw(8) << "Bin text"
+              << " | " << std::setw(8) << "Bin RAM"
+              << " | " << "Text vs base\n";
+    std::cout << std::string(95, '-') << "\n";
+
+    for (const auto &r : results) {
+        print_result(r, results[0]);
+    }
+
+    std::cout << "\nNote: bytes; text ~ flash, RAM = data + bss; binaries stripped, --gc-sections\n";
+    std::cout << "Freestanding RAM includes the static line buffer (ECHO_LINE_BUFFER_SIZE = 256)\n";
+
+    bench::Report report("size", argc, argv); // Sizes in bytes, -1 = not measured
+    auto ram = [](const Sizes &s) { return static_cast<double>(s.data < 0 ? -1 : s.data + s.bss); };
+    for (const auto &r : results) {
+        report.add(r.name, {{"object_text", static_cast<double>(r.object.text)},
+                            {"object_ram", ram(r.object)},
+                            {"binary_text", static_cast<double>(r.binary.text)},
+                            {"binary_ram", ram(r.binary)}});
+    }
+    return report.write_json() ? 0 : 1;
+}
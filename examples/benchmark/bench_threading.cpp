@@ -7,6 +7,10 @@
  * - Multiple threads logging simultaneously
  * - Thread contention scenarios
  * - Scalability with thread count
+ *
+ * Counters are opened in each worker thread and averaged over the workers.
+ *
+ * Usage: bench_threading [--json results.json]
  */
 
 #include <echo/core/level.hpp>
@@ -14,6 +18,8 @@
 #include <echo/sinks/null_sink.hpp>
 #include <echo/sinks/registry.hpp>
 
+#include "perf_counters.hpp"
+
 #include <atomic>
 #include <chrono>
 #include <iomanip>
@@ -30,6 +36,7 @@ struct BenchResult {
     double duration_ms;
     double ops_per_sec;
     double ops_per_thread_per_sec;
+    bench::PerfSample perf; // per call, averaged over the threads
 };
 
 void print_result(const BenchResult &r) {
@@ -39,22 +46,46 @@ void print_result(const BenchResult &r) {
               << std::setw(12) << r.ops_per_thread_per_sec << "\n";
 }
 
+/// Per-counter mean over the threads that have the counter
+bench::PerfSample average(const std::vector<bench::PerfSample> &samples) {
+    bench::PerfSample avg;
+    for (size_t c = 0; c < bench::COUNTER_COUNT; ++c) {
+        double sum = 0;
+        size_t n = 0;
+        for (const auto &s : samples) {
+            if (s.values[c]) {
+                sum += *s.values[c];
+                ++n;
+            }
+        }
+        if (n > 0) {
+            avg.values[c] = sum / static_cast<double>(n);
+        }
+    }
+    return avg;
+}
+
 BenchResult benchmark_threads(const std::string &name, size_t num_threads, size_t ops_per_thread) {
     std::atomic<size_t> ready_count{0};
     std::atomic<bool> start{false};
     std::vector<std::thread> threads;
+    std::vector<bench::PerfSample> samples(num_threads);
 
     auto start_time = high_resolution_clock::now();
 
     for (size_t i = 0; i < num_threads; ++i) {
         threads.emplace_back([&, i]() {
+            bench::PerfCounters perf; // Counts this thread only
             ready_count++;
             while (!start.load())
                 ; // Spin wait for synchronized start
 
+            perf.start();
             for (size_t j = 0; j < ops_per_thread; ++j) {
                 echo::info("Thread ", i, " message ", j);
             }
+            perf.stop();
+            samples[i] = perf.sample(ops_per_thread);
         });
     }
 
@@ -78,10 +109,10 @@ BenchResult benchmark_threads(const std::string &name, size_t num_threads, size_
     double ops_per_sec = (total_ops / duration_ms) * 1000.0;
     double ops_per_thread_per_sec = ops_per_sec / num_threads;
 
-    return {name, num_threads, total_ops, duration_ms, ops_per_sec, ops_per_thread_per_sec};
+    return {name, num_threads, total_ops, duration_ms, ops_per_sec, ops_per_thread_per_sec, average(samples)};
 }
 
-int main() {
+int main(int argc, char **argv) {
     std::cout << "\n=== THREADING PERFORMANCE BENCHMARKS ===\n\n";
 
     // Use null sink for fair benchmarking
@@ -117,5 +148,15 @@ int main() {
     std::cout << "\nNote: All benchmarks use NullSink to isolate threading overhead\n";
     std::cout << "Ops/t/sec = Operations per thread per second\n";
 
-    return 0;
+    bench::Report report("threading", argc, argv);
+    for (const auto &r : results) {
+        report.add(r.name,
+                   {{"threads", static_cast<double>(r.num_threads)},
+                    {"total_ops", static_cast<double>(r.total_ops)},
+                    {"duration_ms", r.duration_ms},
+                    {"ops_per_sec", r.ops_per_sec},
+                    {"ops_per_thread_per_sec", r.ops_per_thread_per_sec}},
+                   r.perf);
+    }
+    return report.finish(30);
 }
@@ -7,6 +7,8 @@
  * - Formatting overhead
  * - Level filtering
  * - Threading performance
+ *
+ * Usage: bench_vs_spdlog [--json results.json]
  */
 
 #include <echo/core/level.hpp>
@@ -17,6 +19,8 @@
 #include <spdlog/sinks/null_sink.h>
 #include <spdlog/spdlog.h>
 
+#include "perf_counters.hpp"
+
 #include <algorithm>
 #include <chrono>
 #include <iomanip>
@@ -38,6 +42,7 @@ struct BenchResult {
     double p99_ns;
     size_t iterations;
     double ops_per_sec;
+    bench::PerfSample perf; // per call
 };
 
 template <typename Func> BenchResult benchmark(const std::string &name, Func func, size_t iterations = 100000) {
@@ -75,8 +80,19 @@ template <typename Func> BenchResult benchmark(const std::string &name, Func fun
     size_t p95_idx = iterations * 95 / 100;
     size_t p99_idx = iterations * 99 / 100;
 
-    return {name,       avg,      min_val, max_val, sorted_times[p50_idx], sorted_times[p95_idx], sorted_times[p99_idx],
-            iterations, 1e9 / avg};
+    // Counters are taken in a separate untimed pass, so clock reads do not show up in them
+    bench::PerfSample perf = bench::measure_counters(func, iterations);
+
+    return {name,
+            avg,
+            min_val,
+            max_val,
+            sorted_times[p50_idx],
+            sorted_times[p95_idx],
+            sorted_times[p99_idx],
+            iterations,
+            1e9 / avg,
+            perf};
 }
 
 void print_result(const BenchResult &r) {
@@ -96,7 +112,7 @@ void print_comparison(const BenchResult &echo_result, const BenchResult &spdlog_
               << percent << "% | " << winner << "\n";
 }
 
-int main() {
+int main(int argc, char **argv) {
     std::cout << "\n=== ECHO vs SPDLOG PERFORMANCE COMPARISON ===\n\n";
 
     // Setup echo with null sink
@@ -236,5 +252,19 @@ int main() {
     std::cout << "\nNote: All benchmarks use null sinks to isolate logging overhead\n";
     std::cout << "Speedup = spdlog_time / echo_time (>1.0 means echo is faster)\n";
 
-    return 0;
+    bench::Report report("vs_spdlog", argc, argv);
+    for (size_t i = 0; i < echo_results.size(); ++i) {
+        for (const auto *r : {&echo_results[i], &spdlog_results[i]}) {
+            report.add(r->name,
+                       {{"avg_ns", r->avg_ns},
+                        {"min_ns", r->min_ns},
+                        {"max_ns", r->max_ns},
+                        {"p50_ns", r->p50_ns},
+                        {"p95_ns", r->p95_ns},
+                        {"p99_ns", r->p99_ns},
+                        {"ops_per_sec", r->ops_per_sec}},
+                       r->perf);
+        }
+    }
+    return report.finish(40);
 }
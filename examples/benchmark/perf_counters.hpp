@@ -0,0 +1,429 @@
+#pragma once
+
+/**
+ * @file perf_counters.hpp
+ * @brief Optional hardware/software performance counters for the benchmarks
+ *
+ * Wraps Linux perf_event_open() to count, for the calling thread:
+ * - cycles, instructions (and IPC)
+ * - L1 data cache read misses, last-level cache misses
+ * - branch misses
+ * - context switches
+ *
+ * Every counter is opened independently, so a missing one (no PMU in a VM or
+ * container, perf_event_paranoid, seccomp, non-Linux build) only leaves that
+ * value empty; the benchmark always runs. Set ECHO_BENCH_PERF=0 to skip
+ * counters entirely.
+ *
+ * Every benchmark in this directory reports through bench::Report: it collects
+ * each case's wall-clock numbers and counters, prints the counter table and
+ * writes everything as JSON with --json <path>.
+ *
+ * Example:
+ *   bench::Report report("basic", argc, argv);
+ *   auto perf = bench::measure_counters([] { echo::info("x"); }, n);
+ *   report.add("Simple string", {{"avg_ns", avg}}, perf);
+ *   return report.finish();
+ */
+
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+    enum class Counter { Cycles, Instructions, L1dMisses, LlcMisses, BranchMisses, ContextSwitches, Count };
+
+    constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::Count);
+
+    /// JSON/table names, indexed by Counter
+    constexpr std::array<const char *, COUNTER_COUNT> COUNTER_NAMES = {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "context_switches"};
+
+    /**
+     * @brief Counter values per operation (empty where the counter is unavailable)
+     */
+    struct PerfSample {
+        std::array<std::optional<double>, COUNTER_COUNT> values{};
+
+        [[nodiscard]] std::optional<double> get(Counter c) const { return values[static_cast<size_t>(c)]; }
+
+        [[nodiscard]] std::optional<double> ipc() const {
+            auto cycles = get(Counter::Cycles);
+            auto instructions = get(Counter::Instructions);
+            if (!cycles || !instructions || *cycles <= 0) {
+                return std::nullopt;
+            }
+            return *instructions / *cycles;
+        }
+    };
+
+    /**
+     * @brief A set of per-thread perf counters
+     */
+    class PerfCounters {
+      private:
+        std::array<int, COUNTER_COUNT> fds_;
+
+#ifdef __linux__
+        struct ReadFormat {
+            uint64_t value;
+            uint64_t time_enabled;
+            uint64_t time_running;
+        };
+
+        static int open_counter(uint32_t type, uint64_t config, bool exclude_kernel) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = 1;
+            attr.exclude_kernel = exclude_kernel ? 1 : 0;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+
+        static int open_counter(Counter c) {
+            switch (c) {
+            case Counter::Cycles:
+                return open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, true);
+            case Counter::Instructions:
+                return open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, true);
+            case Counter::L1dMisses:
+                return open_counter(PERF_TYPE_HW_CACHE,
+                                    PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+                                    true);
+            case Counter::LlcMisses:
+                return open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, true);
+            case Counter::BranchMisses:
+                return open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, true);
+            case Counter::ContextSwitches: {
+                // Switches happen in the kernel; counting them there may need a lower paranoid level
+                int fd = open_counter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, false);
+                return fd != -1 ? fd : open_counter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, true);
+            }
+            default:
+                return -1;
+            }
+        }
+#endif
+
+        template <typename Op> void for_each_fd(Op op) {
+            for (int fd : fds_) {
+                if (fd != -1) {
+                    op(fd);
+                }
+            }
+        }
+
+      public:
+        PerfCounters() {
+            fds_.fill(-1);
+#ifdef __linux__
+            const char *env = std::getenv("ECHO_BENCH_PERF");
+            if (env && std::string(env) == "0") {
+                return;
+            }
+            for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+                fds_[i] = open_counter(static_cast<Counter>(i));
+            }
+#endif
+        }
+
+        ~PerfCounters() {
+#ifdef __linux__
+            for_each_fd([](int fd) { close(fd); });
+#endif
+        }
+
+        PerfCounters(const PerfCounters &) = delete;
+        PerfCounters &operator=(const PerfCounters &) = delete;
+
+        /// True if at least one counter could be opened
+        [[nodiscard]] bool available() const {
+            for (int fd : fds_) {
+                if (fd != -1) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        [[nodiscard]] bool available(Counter c) const { return fds_[static_cast<size_t>(c)] != -1; }
+
+        /// Reset and start all counters
+        void start() {
+#ifdef __linux__
+            for_each_fd([](int fd) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            });
+#endif
+        }
+
+        /// Stop all counters
+        void stop() {
+#ifdef __linux__
+            for_each_fd([](int fd) { ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); });
+#endif
+        }
+
+        /**
+         * @brief Read counts since start(), divided by the number of operations
+         *
+         * Counts are scaled up when the kernel multiplexed a counter (it ran for
+         * only part of the enabled time).
+         */
+        [[nodiscard]] PerfSample sample(size_t operations) const {
+            PerfSample s;
+#ifdef __linux__
+            for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+                ReadFormat rf{};
+                if (fds_[i] == -1 || ::read(fds_[i], &rf, sizeof(rf)) != static_cast<ssize_t>(sizeof(rf)) ||
+                    rf.time_running == 0) {
+                    continue;
+                }
+                double value = static_cast<double>(rf.value) * static_cast<double>(rf.time_enabled) /
+                               static_cast<double>(rf.time_running);
+                s.values[i] = value / static_cast<double>(operations ? operations : 1);
+            }
+#else
+            (void)operations;
+#endif
+            return s;
+        }
+    };
+
+    /// Counters of the main benchmark thread, opened on first use
+    inline PerfCounters &main_counters() {
+        static PerfCounters counters;
+        return counters;
+    }
+
+    /**
+     * @brief Count per-operation events for `iterations` calls of func
+     *
+     * Each call is taken to perform `operations_per_call` operations (e.g. the
+     * records of one batch), so the sample is always per log record.
+     */
+    template <typename Func>
+    PerfSample measure_counters(PerfCounters &perf, Func func, size_t iterations = 100000,
+                                size_t operations_per_call = 1) {
+        perf.start();
+        for (size_t i = 0; i < iterations; ++i) {
+            func();
+        }
+        perf.stop();
+        return perf.sample(iterations * operations_per_call);
+    }
+
+    /// measure_counters() on the main thread's counters
+    template <typename Func>
+    PerfSample measure_counters(Func func, size_t iterations = 100000, size_t operations_per_call = 1) {
+        return measure_counters(main_counters(), func, iterations, operations_per_call);
+    }
+
+    // =================================================================================================
+    // Output helpers
+    // =================================================================================================
+
+    inline void write_json_string(std::ostream &out, const std::string &s) {
+        out << '"';
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out << ' ';
+            } else {
+                out << c;
+            }
+        }
+        out << '"';
+    }
+
+    // Missing and non-finite values (e.g. IPC with zero cycles) are written as null: JSON has no inf/nan
+    inline void write_json_number(std::ostream &out, std::optional<double> v) {
+        if (v && std::isfinite(*v)) {
+            out << *v;
+        } else {
+            out << "null";
+        }
+    }
+
+    /**
+     * @brief Write a sample as a JSON object: {"cycles": 123.4, ..., "ipc": 1.2}
+     */
+    inline void write_json(std::ostream &out, const PerfSample &s) {
+        out << '{';
+        for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+            out << '"' << COUNTER_NAMES[i] << "\": ";
+            write_json_number(out, s.values[i]);
+            out << ", ";
+        }
+        out << "\"ipc\": ";
+        write_json_number(out, s.ipc());
+        out << '}';
+    }
+
+    /// Fixed-width table cell: value with one decimal, or "-" when unavailable
+    inline std::string format_cell(std::optional<double> v, int precision = 1) {
+        if (!v) {
+            return "-";
+        }
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.*f", precision, *v);
+        return buf;
+    }
+
+    // =================================================================================================
+    // Shared runner
+    // =================================================================================================
+
+    /// A named wall-clock result of one case, e.g. {"avg_ns", 41.2}
+    using Metric = std::pair<std::string, double>;
+
+    struct CaseResult {
+        std::string name;
+        std::vector<Metric> metrics;
+        PerfSample perf; ///< Per log call
+    };
+
+    /**
+     * @brief Results of one benchmark program: counter table and JSON output
+     *
+     * The constructor picks up `--json <path>` from the command line; finish()
+     * prints the per-call counter table and writes the JSON file, if requested:
+     *
+     * {"benchmark": "basic", "perf_available": true, "cases": [
+     *     {"name": "...", "avg_ns": 41.2, ..., "perf": {"cycles": 150.3, ..., "ipc": 2.1}}]}
+     */
+    class Report {
+      private:
+        std::string benchmark_;
+        std::string json_path_;
+        std::vector<CaseResult> cases_;
+
+      public:
+        Report(std::string benchmark, int argc, char **argv) : benchmark_(std::move(benchmark)) {
+            for (int i = 1; i + 1 < argc; ++i) {
+                if (std::string(argv[i]) == "--json") {
+                    json_path_ = argv[i + 1];
+                }
+            }
+        }
+
+        void add(std::string name, std::vector<Metric> metrics, const PerfSample &perf = {}) {
+            cases_.push_back({std::move(name), std::move(metrics), perf});
+        }
+
+        /// True if any case got at least one counter value
+        [[nodiscard]] bool perf_available() const {
+            for (const auto &c : cases_) {
+                for (const auto &v : c.perf.values) {
+                    if (v) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void print_counters(int name_width = 40) const {
+            std::cout << "\n=== PER-CALL COUNTERS ===\n\n";
+            if (!perf_available()) {
+                std::cout << "perf_event_open unavailable (container, VM, perf_event_paranoid or ECHO_BENCH_PERF=0); "
+                             "counters skipped\n";
+                return;
+            }
+            std::cout << std::left << std::setw(name_width) << "Benchmark"
+                      << " | " << std::setw(8) << "Cycles"
+                      << " | " << std::setw(8) << "Instr"
+                      << " | " << std::setw(5) << "IPC"
+                      << " | " << std::setw(8) << "L1D miss"
+                      << " | " << std::setw(8) << "LLC miss"
+                      << " | " << std::setw(8) << "Br miss"
+                      << " | " << "Ctx sw\n";
+            std::cout << std::string(static_cast<size_t>(name_width) + 75, '-') << "\n";
+            for (const auto &c : cases_) {
+                std::cout << std::left << std::setw(name_width) << c.name << std::right;
+                for (auto counter : {Counter::Cycles, Counter::Instructions}) {
+                    std::cout << " | " << std::setw(8) << format_cell(c.perf.get(counter));
+                }
+                std::cout << " | " << std::setw(5) << format_cell(c.perf.ipc(), 2);
+                for (auto counter :
+                     {Counter::L1dMisses, Counter::LlcMisses, Counter::BranchMisses, Counter::ContextSwitches}) {
+                    std::cout << " | " << std::setw(8) << format_cell(c.perf.get(counter), 3);
+                }
+                std::cout << "\n";
+            }
+            std::cout << "\nNote: events per log call (per record for batches); \"-\" = counter not available\n";
+        }
+
+        /// Write all cases to the --json path (no-op without one); false if the file could not be written
+        bool write_json() const {
+            if (json_path_.empty()) {
+                return true;
+            }
+            std::ofstream out(json_path_);
+            if (!out) {
+                std::cerr << "error: cannot open " << json_path_ << " for writing: " << std::strerror(errno) << "\n";
+                return false;
+            }
+            out << std::setprecision(10);
+            out << "{\n  \"benchmark\": ";
+            write_json_string(out, benchmark_);
+            out << ",\n  \"perf_available\": " << (perf_available() ? "true" : "false") << ",\n  \"cases\": [\n";
+            for (size_t i = 0; i < cases_.size(); ++i) {
+                const auto &c = cases_[i];
+                out << "    {\"name\": ";
+                write_json_string(out, c.name);
+                for (const auto &[key, value] : c.metrics) {
+                    out << ", ";
+                    write_json_string(out, key);
+                    out << ": ";
+                    write_json_number(out, value);
+                }
+                out << ", \"perf\": ";
+                bench::write_json(out, c.perf);
+                out << "}" << (i + 1 < cases_.size() ? "," : "") << "\n";
+            }
+            out << "  ]\n}\n";
+            out.close();
+            if (!out) {
+                std::cerr << "error: failed writing " << json_path_ << "\n";
+                return false;
+            }
+            std::cout << "\nJSON results written to " << json_path_ << "\n";
+            return true;
+        }
+
+        /// Print the counter table, write the JSON file; returns main()'s exit code
+        int finish(int name_width = 40) const {
+            print_counters(name_width);
+            return write_json() ? 0 : 1;
+        }
+    };
+
+} // namespace bench
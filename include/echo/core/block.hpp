@@ -0,0 +1,129 @@
+#pragma once
+
+/**
+ * @file core/block.hpp
+ * @brief Multi-line log blocks written as one unit
+ *
+ * Lines added to a block are formatted immediately but only reach the sinks
+ * when the block is submitted, all at once. Other threads cannot interleave
+ * their output between the lines, without the caller holding a lock across
+ * several log calls.
+ *
+ * Example (RAII):
+ *   {
+ *       echo::block b;
+ *       b.info("request ", id, " from ", peer);
+ *       b.debug("  headers: ", headers.size());
+ *       b.warn("  took ", ms, "ms");
+ *   } // written here
+ *
+ * Example (builder):
+ *   echo::block().info("summary").info("  rows: ", rows).info("  errors: ", errors);
+ */
+
+#include <echo/core/formatter.hpp>
+#include <echo/core/level.hpp>
+#include <echo/core/mutex.hpp>
+#include <echo/core/proxy.hpp>
+#include <echo/sinks/registry.hpp>
+#include <echo/sinks/sink.hpp>
+
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace echo {
+
+    /**
+     * @brief Accumulates leveled lines and writes them to the sinks as one unit
+     *
+     * Each line obeys the compile-time and runtime level like echo::info() etc.
+     * Per-sink levels are applied by Sink::write_block(), which drops filtered
+     * lines and writes the rest in a single call. Metric rules (see
+     * echo::add_metric_rule()) observe each line when it is added, so a
+     * discarded block still counts; a line a rule consumes is not added.
+     *
+     * The block is submitted by submit() or by the destructor, whichever comes
+     * first. Not thread-safe: build a block on one thread.
+     */
+    class block {
+      private:
+        LogBlock block_;
+
+        template <Level L, typename... Args> block &add(const Args &...args) {
+            if constexpr (static_cast<int>(L) >= static_cast<int>(detail::ACTIVE_LEVEL)) {
+                if (static_cast<int>(L) >= static_cast<int>(detail::get_effective_level())) {
+                    size_t cap = detail::get_max_record_size().load(std::memory_order_relaxed);
+                    std::string message = detail::build_message_bounded(cap, args...);
+                    // Metric rules see block lines like single records and may consume them
+                    if (auto observe = detail::get_record_observer().load(std::memory_order_acquire)) {
+                        if (observe(L, nullptr, message)) {
+                            return *this;
+                        }
+                    }
+                    size_t begin = block_.text.size();
+                    detail::append_log_message(block_.text, L, message, "", false);
+                    block_.lines.push_back({L, begin, block_.text.size()});
+                }
+            }
+            return *this;
+        }
+
+      public:
+        block() = default;
+
+        block(block &&other) noexcept : block_(std::move(other.block_)) { other.block_.clear(); }
+
+        block &operator=(block &&other) noexcept {
+            if (this != &other) {
+                submit();
+                block_ = std::move(other.block_);
+                other.block_.clear();
+            }
+            return *this;
+        }
+
+        // Prevent copying (a copy would be written twice)
+        block(const block &) = delete;
+        block &operator=(const block &) = delete;
+
+        ~block() { submit(); }
+
+        template <typename... Args> block &trace(const Args &...args) { return add<Level::Trace>(args...); }
+        template <typename... Args> block &debug(const Args &...args) { return add<Level::Debug>(args...); }
+        template <typename... Args> block &info(const Args &...args) { return add<Level::Info>(args...); }
+        template <typename... Args> block &warn(const Args &...args) { return add<Level::Warn>(args...); }
+        template <typename... Args> block &error(const Args &...args) { return add<Level::Error>(args...); }
+        template <typename... Args> block &critical(const Args &...args) { return add<Level::Critical>(args...); }
+
+        /**
+         * @brief Write the accumulated lines now and start a new, empty block
+         */
+        void submit() {
+            if (block_.empty()) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(detail::get_log_mutex());
+                detail::SinkRegistry::instance().write_block_all(block_);
+            }
+            block_.clear();
+        }
+
+        /**
+         * @brief Drop the accumulated lines without writing them
+         */
+        void discard() noexcept { block_.clear(); }
+
+        /**
+         * @brief Number of lines waiting to be written
+         */
+        [[nodiscard]] size_t size() const noexcept { return block_.lines.size(); }
+
+        /**
+         * @brief Check whether there is nothing to write
+         */
+        [[nodiscard]] bool empty() const noexcept { return block_.empty(); }
+    };
+
+} // namespace echo
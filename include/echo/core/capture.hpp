@@ -0,0 +1,444 @@
+#pragma once
+
+/**
+ * @file core/capture.hpp
+ * @brief Capture of foreign stdout/stderr output into the sink pipeline
+ *
+ * Third-party code that calls printf()/fprintf(stderr) (or writes to fds 1/2
+ * directly) bypasses echo's sinks and interleaves with its console output.
+ * StdioCapture redirects fds 1 and 2 into pipes, reads them on a background
+ * thread, splits the output into lines, and logs each line with a
+ * configurable category and level. ConsoleSink keeps writing to the original
+ * terminal, so nothing is captured twice.
+ *
+ * Only available on Unix/Linux.
+ *
+ * Example:
+ *   echo::add_sink(std::make_shared<echo::FileSink>("app.log"));
+ *
+ *   echo::StdioCapture capture;  // stdout -> Info "stdout", stderr -> Warn "stderr"
+ *   capture.start();
+ *   legacy_library_init();       // its printf() output now reaches app.log
+ *   capture.stop();
+ */
+
+#include <echo/core/console.hpp>
+#include <echo/core/level.hpp>
+#include <echo/core/mutex.hpp>
+#include <echo/core/proxy.hpp>
+#include <echo/filters/category.hpp>
+#include <echo/sinks/registry.hpp>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#endif
+
+namespace echo {
+
+#ifdef __unix__
+
+    namespace detail {
+
+        /**
+         * @brief Unbuffered streambuf writing straight to a file descriptor
+         */
+        class FdStreambuf : public std::streambuf {
+          private:
+            int fd_;
+
+            bool write_all(const char *data, size_t size) {
+                while (size > 0) {
+                    ssize_t n = ::write(fd_, data, size);
+                    if (n < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        return false;
+                    }
+                    data += n;
+                    size -= static_cast<size_t>(n);
+                }
+                return true;
+            }
+
+          protected:
+            std::streamsize xsputn(const char *s, std::streamsize n) override {
+                return write_all(s, static_cast<size_t>(n)) ? n : 0;
+            }
+
+            int_type overflow(int_type ch) override {
+                if (traits_type::eq_int_type(ch, traits_type::eof())) {
+                    return traits_type::not_eof(ch);
+                }
+                char c = traits_type::to_char_type(ch);
+                return write_all(&c, 1) ? ch : traits_type::eof();
+            }
+
+          public:
+            explicit FdStreambuf(int fd) : fd_(fd) {}
+        };
+
+        /**
+         * @brief Format one captured line with a runtime level and category
+         * @return false if the line is filtered out
+         */
+        inline bool format_captured_line(std::string &formatted, Level level, const std::string &category,
+                                         std::string_view line, bool tag) {
+            if (static_cast<int>(level) < static_cast<int>(ACTIVE_LEVEL) ||
+                !CategoryRegistry::instance().should_log(category, level)) {
+                return false;
+            }
+
+            std::string message;
+            message.reserve(line.size() + category.size() + 3);
+            if (tag) {
+                message += '[';
+                message += category;
+                message += "] ";
+            }
+            message += line;
+
+            formatted.clear();
+            append_log_message(formatted, level, message, "", false);
+            return true;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Options for StdioCapture
+     */
+    struct StdioCaptureOptions {
+        bool capture_stdout = true;             ///< Redirect fd 1
+        std::string stdout_category = "stdout"; ///< Category of captured stdout lines
+        Level stdout_level = Level::Info;       ///< Level of captured stdout lines
+
+        bool capture_stderr = true;             ///< Redirect fd 2
+        std::string stderr_category = "stderr"; ///< Category of captured stderr lines
+        Level stderr_level = Level::Warn;       ///< Level of captured stderr lines
+
+        bool tag_lines = true;          ///< Prefix each line with "[category] "
+        size_t max_line_length = 16384; ///< Longer lines are split into several records
+    };
+
+    /**
+     * @brief Redirects fds 1/2 into the sink pipeline while active
+     *
+     * Lines are logged through the sink registry with the configured level and
+     * category, honoring echo::set_level() and echo::set_category_level().
+     * A line still incomplete at stop() is logged as is. Only one capture can
+     * be active per process; start() fails on a second one.
+     *
+     * The reader thread never waits for the log mutex while capturing: whoever
+     * holds it may be writing to fd 1/2 and need the pipe drained. Lines are
+     * queued and handed to the sinks whenever the mutex is free.
+     */
+    class StdioCapture {
+      private:
+        struct Channel {
+            int target_fd = -1; // 1 or 2
+            int saved_fd = -1;  // dup of the original fd (the terminal)
+            int read_fd = -1;   // read end of the capture pipe
+            std::string pending;
+            std::unique_ptr<detail::FdStreambuf> buf;
+            std::unique_ptr<std::ostream> stream;
+            const std::string *category = nullptr;
+            Level level = Level::Info;
+        };
+
+        struct QueuedLine {
+            Level level;
+            std::string formatted;
+        };
+
+        StdioCaptureOptions options_;
+        Channel out_, err_;
+        std::vector<QueuedLine> queued_; // Formatted lines waiting for the log mutex (reader thread only)
+        int wake_[2] = {-1, -1};
+        std::thread reader_;
+        bool active_ = false;
+
+        static std::atomic<bool> &any_active() {
+            static std::atomic<bool> flag{false};
+            return flag;
+        }
+
+        static void close_fd(int &fd) {
+            if (fd != -1) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+
+        /**
+         * @brief Point target_fd at a new pipe, keeping a dup of the original
+         */
+        static bool redirect(Channel &ch) {
+            int fds[2];
+            if (::pipe(fds) != 0) {
+                return false;
+            }
+            ch.saved_fd = ::fcntl(ch.target_fd, F_DUPFD_CLOEXEC, 3);
+            if (ch.saved_fd == -1 || ::dup2(fds[1], ch.target_fd) == -1) {
+                ::close(fds[0]);
+                ::close(fds[1]);
+                close_fd(ch.saved_fd);
+                return false;
+            }
+            ::close(fds[1]);
+            ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+            ch.read_fd = fds[0];
+            ch.buf = std::make_unique<detail::FdStreambuf>(ch.saved_fd);
+            ch.stream = std::make_unique<std::ostream>(ch.buf.get());
+            return true;
+        }
+
+        static void restore(Channel &ch) {
+            if (ch.saved_fd != -1) {
+                ::dup2(ch.saved_fd, ch.target_fd);
+            }
+        }
+
+        void emit_lines(Channel &ch, bool final) {
+            size_t start = 0;
+            while (true) {
+                size_t nl = ch.pending.find('\n', start);
+                if (nl == std::string::npos) {
+                    break;
+                }
+                emit(ch, std::string_view(ch.pending).substr(start, nl - start));
+                start = nl + 1;
+            }
+            ch.pending.erase(0, start);
+
+            while (ch.pending.size() >= options_.max_line_length) {
+                emit(ch, std::string_view(ch.pending).substr(0, options_.max_line_length));
+                ch.pending.erase(0, options_.max_line_length);
+            }
+            if (final && !ch.pending.empty()) {
+                emit(ch, ch.pending);
+                ch.pending.clear();
+            }
+        }
+
+        void emit(const Channel &ch, std::string_view line) {
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            QueuedLine queued{ch.level, {}};
+            if (detail::format_captured_line(queued.formatted, ch.level, *ch.category, line, options_.tag_lines)) {
+                queued_.push_back(std::move(queued));
+            }
+        }
+
+        /**
+         * @brief Hand queued lines to the sinks
+         * @param wait Block for the log mutex; otherwise keep the lines queued if it is taken
+         */
+        void deliver(bool wait) {
+            if (queued_.empty()) {
+                return;
+            }
+            std::unique_lock<std::mutex> lock(detail::get_log_mutex(), std::defer_lock);
+            if (wait) {
+                lock.lock();
+            } else if (!lock.try_lock()) {
+                return;
+            }
+            for (const auto &line : queued_) {
+                detail::get_sink_writer()(line.level, line.formatted);
+            }
+            queued_.clear();
+        }
+
+        /**
+         * @brief One read from the pipe; returns false at EOF (or when nothing is left, if non-blocking)
+         */
+        bool read_some(Channel &ch) {
+            char buffer[4096];
+            ssize_t n;
+            do {
+                n = ::read(ch.read_fd, buffer, sizeof(buffer));
+            } while (n < 0 && errno == EINTR);
+
+            if (n <= 0) {
+                return false;
+            }
+            ch.pending.append(buffer, static_cast<size_t>(n));
+            emit_lines(ch, false);
+            return true;
+        }
+
+        void run() {
+            pollfd fds[3];
+            int count = 0;
+            Channel *channels[2];
+            for (Channel *ch : {&out_, &err_}) {
+                if (ch->read_fd != -1) {
+                    channels[count] = ch;
+                    fds[count++] = {ch->read_fd, POLLIN, 0};
+                }
+            }
+            fds[count] = {wake_[0], POLLIN, 0};
+
+            while (true) {
+                // With lines queued, retry the log mutex every millisecond
+                if (::poll(fds, static_cast<nfds_t>(count + 1), queued_.empty() ? -1 : 1) < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    break;
+                }
+                for (int i = 0; i < count; ++i) {
+                    if (fds[i].fd != -1 && (fds[i].revents & (POLLIN | POLLHUP))) {
+                        if (!read_some(*channels[i])) {
+                            fds[i].fd = -1; // EOF: poll ignores negative fds
+                        }
+                    }
+                }
+                deliver(false);
+                if (fds[count].revents & POLLIN) {
+                    break;
+                }
+            }
+
+            // Stopping: fds 1/2 already point back at the terminal; take what is left
+            for (int i = 0; i < count; ++i) {
+                int flags = ::fcntl(channels[i]->read_fd, F_GETFL);
+                ::fcntl(channels[i]->read_fd, F_SETFL, flags | O_NONBLOCK);
+                while (read_some(*channels[i])) {
+                }
+                emit_lines(*channels[i], true);
+            }
+            deliver(true);
+        }
+
+      public:
+        explicit StdioCapture(StdioCaptureOptions options = {}) : options_(std::move(options)) {
+            out_.target_fd = STDOUT_FILENO;
+            out_.category = &options_.stdout_category;
+            out_.level = options_.stdout_level;
+            err_.target_fd = STDERR_FILENO;
+            err_.category = &options_.stderr_category;
+            err_.level = options_.stderr_level;
+            if (options_.max_line_length == 0) {
+                options_.max_line_length = 1;
+            }
+        }
+
+        ~StdioCapture() { stop(); }
+
+        // Prevent copying
+        StdioCapture(const StdioCapture &) = delete;
+        StdioCapture &operator=(const StdioCapture &) = delete;
+
+        /**
+         * @brief Start capturing
+         * @return false if another capture is active or the redirection failed
+         */
+        bool start() {
+            if (active_ || any_active().exchange(true)) {
+                return false;
+            }
+
+            std::fflush(stdout);
+            std::fflush(stderr);
+            std::cout.flush();
+            std::cerr.flush();
+
+            bool ok = ::pipe(wake_) == 0;
+            if (ok && options_.capture_stdout) {
+                ok = redirect(out_);
+            }
+            if (ok && options_.capture_stderr) {
+                ok = redirect(err_);
+            }
+            if (!ok) {
+                restore(out_);
+                restore(err_);
+                cleanup();
+                any_active() = false;
+                return false;
+            }
+
+            {
+                // ConsoleSink keeps writing to the terminal
+                std::lock_guard<std::mutex> lock(detail::get_log_mutex());
+                if (out_.stream) {
+                    detail::console_targets().out.store(out_.stream.get(), std::memory_order_release);
+                }
+                if (err_.stream) {
+                    detail::console_targets().err.store(err_.stream.get(), std::memory_order_release);
+                }
+            }
+
+            active_ = true;
+            reader_ = std::thread([this] { run(); });
+            return true;
+        }
+
+        /**
+         * @brief Stop capturing, log any remaining output, and restore fds 1/2
+         */
+        void stop() {
+            if (!active_) {
+                return;
+            }
+
+            std::fflush(stdout);
+            std::fflush(stderr);
+            restore(out_);
+            restore(err_);
+
+            char wake = 1;
+            ssize_t written = ::write(wake_[1], &wake, 1);
+            (void)written;
+            reader_.join();
+
+            {
+                std::lock_guard<std::mutex> lock(detail::get_log_mutex());
+                detail::console_targets().out.store(nullptr, std::memory_order_release);
+                detail::console_targets().err.store(nullptr, std::memory_order_release);
+            }
+
+            cleanup();
+            active_ = false;
+            any_active() = false;
+        }
+
+        /**
+         * @brief Check whether this capture is running
+         */
+        [[nodiscard]] bool active() const { return active_; }
+
+      private:
+        void cleanup() {
+            for (Channel *ch : {&out_, &err_}) {
+                close_fd(ch->read_fd);
+                close_fd(ch->saved_fd);
+                ch->stream.reset();
+                ch->buf.reset();
+                ch->pending.clear();
+            }
+            close_fd(wake_[0]);
+            close_fd(wake_[1]);
+        }
+    };
+
+#endif // __unix__
+
+} // namespace echo
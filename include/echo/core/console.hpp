@@ -0,0 +1,41 @@
+#pragma once
+
+/**
+ * @file core/console.hpp
+ * @brief Console streams used for terminal output, redirectable while stdio is captured
+ */
+
+#include <atomic>
+#include <iostream>
+
+namespace echo {
+    namespace detail {
+
+        /**
+         * @brief Streams console output goes to, when not std::cout/std::cerr
+         *
+         * Set by StdioCapture while fds 1/2 are redirected, so console output
+         * still reaches the terminal instead of being captured again.
+         */
+        struct ConsoleTargets {
+            std::atomic<std::ostream *> out{nullptr}; ///< Replaces std::cout when set
+            std::atomic<std::ostream *> err{nullptr}; ///< Replaces std::cerr when set
+        };
+
+        inline ConsoleTargets &console_targets() {
+            static ConsoleTargets targets;
+            return targets;
+        }
+
+        inline std::ostream &console_out() {
+            std::ostream *out = console_targets().out.load(std::memory_order_acquire);
+            return out ? *out : std::cout;
+        }
+
+        inline std::ostream &console_err() {
+            std::ostream *err = console_targets().err.load(std::memory_order_acquire);
+            return err ? *err : std::cerr;
+        }
+
+    } // namespace detail
+} // namespace echo
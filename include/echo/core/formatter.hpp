@@ -5,8 +5,14 @@
  * @brief Message formatting and type conversion utilities
  */
 
+#include <echo/core/record_size.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <ostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 // Check for std::format support (C++20)
@@ -136,6 +142,92 @@ namespace echo {
         }
 #endif
 
+        // =================================================================================================
+        // Size-capped formatting
+        // =================================================================================================
+
+        // Stream output counted past the cap for the size estimate, in multiples of the cap
+        inline constexpr size_t RECORD_LOOKAHEAD = 8;
+
+        // Result of pretty()/print()/to_string(), by reference when the method returns one
+        template <typename T> inline decltype(auto) convert_with_method(const T &value) {
+            if constexpr (has_pretty<T>::value) {
+                return value.pretty();
+            } else if constexpr (has_print<T>::value) {
+                return value.print();
+            } else {
+                return value.to_string();
+            }
+        }
+
+        /**
+         * @brief Append one argument within the appender's budget
+         *
+         * Produces the same text as build_message() for the kept part. std::format
+         * and operator<< output stops RECORD_LOOKAHEAD caps past the budget. Once
+         * the budget is used up, strings are only measured and other arguments
+         * are not converted at all.
+         */
+        template <typename T> inline void append_bounded(BoundedAppender &out, const T &value) {
+            constexpr bool is_text = std::is_convertible_v<const T &, std::string_view> && !has_pretty<T>::value &&
+                                     !has_print<T>::value && !has_to_string<T>::value;
+            if (out.full()) {
+                if constexpr (is_text) {
+                    out.skip(std::string_view(value).size());
+                } else {
+                    out.give_up();
+                }
+                return;
+            }
+
+            if constexpr (has_pretty<T>::value || has_print<T>::value || has_to_string<T>::value) {
+                // User conversions cannot be interrupted; copy only the part that fits
+                const auto &text = convert_with_method(value);
+                out.append(std::string_view(text));
+            } else if constexpr (is_text) {
+                out.append(std::string_view(value));
+            }
+#ifdef ECHO_HAS_STD_FORMAT
+            else if constexpr (is_std_formattable<T>::value) {
+                BoundedFormatBuffer buffer(out, out.budget() * RECORD_LOOKAHEAD);
+#if defined(__cpp_exceptions)
+                try {
+                    std::format_to(buffer.out(), "{}", value);
+                    buffer.flush();
+                } catch (const BoundedFormatStop &) {
+                    out.give_up();
+                }
+#else
+                std::format_to(buffer.out(), "{}", value);
+                buffer.flush();
+#endif
+            }
+#endif
+            else if constexpr (is_streamable<T>::value) {
+                BoundedStreamBuf buffer(out, out.budget() * RECORD_LOOKAHEAD);
+                std::ostream stream(&buffer);
+                stream << value;
+            } else {
+                out.append("[unprintable]");
+            }
+        }
+
+        /**
+         * @brief build_message() with a size cap enforced while appending
+         * @param cap Maximum message bytes before the truncation marker (0 = unlimited)
+         */
+        template <typename... Args> inline std::string build_message_bounded(size_t cap, const Args &...args) {
+            if (cap == 0) {
+                return build_message(args...);
+            }
+            std::string result;
+            result.reserve(std::min<size_t>(cap, sizeof...(args) * 50));
+            BoundedAppender out(result, cap);
+            (append_bounded(out, args), ...);
+            out.finish();
+            return result;
+        }
+
     } // namespace detail
 
     // =================================================================================================
@@ -143,16 +235,37 @@ namespace echo {
     // =================================================================================================
 
     namespace detail {
+        // Values with spaces or quotes are written as "..." (escaping " and \) so tokens stay space-separated
+        inline void append_kv_value(std::ostringstream &oss, const std::string &value) {
+            if (value.find_first_of(" \"") == std::string::npos) {
+                oss << value;
+                return;
+            }
+            oss << '"';
+            for (char c : value) {
+                if (c == '"' || c == '\\') {
+                    oss << '\\';
+                }
+                oss << c;
+            }
+            oss << '"';
+        }
+
         // Base case: no more arguments
-        inline void append_kv(std::ostringstream &) {}
+        template <bool Quoted> inline void append_kv(std::ostringstream &) {}
 
         // Recursive case: key-value pairs
-        template <typename K, typename V, typename... Rest>
+        template <bool Quoted, typename K, typename V, typename... Rest>
         inline void append_kv(std::ostringstream &oss, const K &key, const V &value, const Rest &...rest) {
-            oss << stringify(key) << "=" << stringify(value);
+            if constexpr (Quoted) {
+                oss << stringify(key) << "=";
+                append_kv_value(oss, stringify(value));
+            } else {
+                oss << stringify(key) << "=" << stringify(value);
+            }
             if constexpr (sizeof...(rest) > 0) {
                 oss << " ";
-                append_kv(oss, rest...);
+                append_kv<Quoted>(oss, rest...);
             }
         }
     } // namespace detail
@@ -160,7 +273,19 @@ namespace echo {
     template <typename... Args> inline std::string kv(const Args &...args) {
         static_assert(sizeof...(args) % 2 == 0, "kv() requires an even number of arguments (key-value pairs)");
         std::ostringstream oss;
-        detail::append_kv(oss, args...);
+        detail::append_kv<false>(oss, args...);
+        return oss.str();
+    }
+
+    /**
+     * @brief kv() that quotes values containing spaces or double quotes
+     *
+     * kv_quoted("msg", "a \"b\"") gives msg="a \"b\"", which metric rules read as one field.
+     */
+    template <typename... Args> inline std::string kv_quoted(const Args &...args) {
+        static_assert(sizeof...(args) % 2 == 0, "kv_quoted() requires an even number of arguments (key-value pairs)");
+        std::ostringstream oss;
+        detail::append_kv<true>(oss, args...);
         return oss.str();
     }
 
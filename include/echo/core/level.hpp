@@ -6,7 +6,10 @@
  */
 
 #include <cstdlib>
+#ifndef ECHO_FREESTANDING
+#include <atomic>
 #include <string>
+#endif
 
 namespace echo {
 
@@ -116,15 +119,46 @@ namespace echo {
         }
 
         inline Level &get_runtime_level() noexcept {
+#ifdef ECHO_FREESTANDING
+            // No environment to read; constant initialization also avoids a guard variable
+#if !defined(LOGLEVEL) && !defined(ECHOLEVEL)
+            static constinit Level runtime_level = Level::Info;
+#else
+            static constinit Level runtime_level = Level::Off;
+#endif
+#else
             static Level runtime_level = init_runtime_level();
+#endif
             return runtime_level;
         }
 
-        [[nodiscard]] inline Level get_effective_level() noexcept {
+        // Level set by the user (runtime level, or the compile-time level when unset)
+        [[nodiscard]] inline Level get_configured_level() noexcept {
             Level runtime = get_runtime_level();
             return (runtime == Level::Off) ? ACTIVE_LEVEL : runtime;
         }
 
+#ifndef ECHO_FREESTANDING
+        /**
+         * @brief Floor raised by the memory governor to shed low levels under pressure (Trace = no shedding)
+         */
+        inline std::atomic<Level> &get_shed_level() noexcept {
+            static std::atomic<Level> shed_level{Level::Trace};
+            return shed_level;
+        }
+#endif
+
+        [[nodiscard]] inline Level get_effective_level() noexcept {
+            Level level = get_configured_level();
+#ifndef ECHO_FREESTANDING
+            Level shed = get_shed_level().load(std::memory_order_relaxed);
+            if (static_cast<int>(shed) > static_cast<int>(level)) {
+                return shed;
+            }
+#endif
+            return level;
+        }
+
         // =================================================================================================
         // ANSI color codes for levels
         // =================================================================================================
@@ -177,7 +211,7 @@ namespace echo {
 
     inline void set_level(Level level) noexcept { detail::get_runtime_level() = level; }
 
-    [[nodiscard]] inline Level get_level() noexcept { return detail::get_effective_level(); }
+    [[nodiscard]] inline Level get_level() noexcept { return detail::get_configured_level(); }
 
     [[nodiscard]] inline constexpr Level current_level() noexcept { return detail::ACTIVE_LEVEL; }
 
@@ -0,0 +1,430 @@
+#pragma once
+
+/**
+ * @file core/memory_governor.hpp
+ * @brief Memory governor: buffer budgets and level shedding driven by cgroup v2 memory pressure
+ *
+ * The governor samples the cgroup v2 memory files of the process:
+ * - memory.pressure: PSI stall percentages ("some avg10=1.50 ..." / "full avg10=0.20 ...")
+ * - memory.current: bytes in use
+ * - memory.high / memory.max: limits ("max" = none)
+ *
+ * Each sample is classified into a MemoryPressure state. Every state has a
+ * budget scale, passed to each sink's set_memory_budget() (network retry
+ * buffer, reliable UDP retransmit window, ...), and a shed level below which
+ * records are dropped before they are formatted. Category levels cannot
+ * bring shed records back; echo::get_level() still reports the level set by
+ * the user.
+ *
+ * A higher state is entered on the first sample that calls for it; a lower
+ * one only after recovery_samples consecutive samples, so budgets do not
+ * flap around a threshold.
+ *
+ * cgroup_dir can point at any directory holding files of the same format,
+ * which drives the governor from a stand-in (tests, hosts without cgroup v2).
+ * A directory without any of the files leaves the governor at Normal.
+ *
+ * Budgets and the shed level are process-wide: run at most one governor.
+ */
+
+#include <echo/core/level.hpp>
+#include <echo/sinks/registry.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace echo {
+
+    /**
+     * @brief Memory pressure state, from least to most constrained
+     */
+    enum class MemoryPressure {
+        Low,      ///< Far below the limit and no stalls: budgets may grow
+        Normal,   ///< Budgets as configured
+        Elevated, ///< Stalls or usage near the limit: budgets shrink, verbose levels are shed
+        Critical  ///< Heavy stalls or usage at the limit: minimal budgets, only warnings and above
+    };
+
+    /**
+     * @brief Lowercase name of a pressure state ("low", "normal", "elevated", "critical")
+     */
+    [[nodiscard]] inline const char *memory_pressure_name(MemoryPressure pressure) noexcept {
+        switch (pressure) {
+        case MemoryPressure::Low:
+            return "low";
+        case MemoryPressure::Normal:
+            return "normal";
+        case MemoryPressure::Elevated:
+            return "elevated";
+        case MemoryPressure::Critical:
+            return "critical";
+        }
+        return "unknown";
+    }
+
+    /**
+     * @brief One reading of the cgroup memory files
+     */
+    struct MemorySample {
+        bool valid = false;      ///< At least one of the files could be read
+        double some_avg10 = 0.0; ///< % of the last 10 s in which some task stalled on memory
+        double full_avg10 = 0.0; ///< % of the last 10 s in which all tasks stalled on memory
+        uint64_t current = 0;    ///< memory.current in bytes
+        uint64_t limit = 0;      ///< Lower of memory.high and memory.max in bytes (0 = no limit)
+
+        /// memory.current as a fraction of the limit (0 without a limit)
+        [[nodiscard]] double usage() const noexcept {
+            return limit ? static_cast<double>(current) / static_cast<double>(limit) : 0.0;
+        }
+    };
+
+    /**
+     * @brief Thresholds and per-state reactions of a MemoryGovernor
+     *
+     * The per-state arrays are indexed by MemoryPressure (Low, Normal, Elevated, Critical).
+     */
+    struct MemoryGovernorOptions {
+        std::string cgroup_dir;                   ///< Directory with the memory files ("" = this process's cgroup)
+        std::chrono::milliseconds interval{1000}; ///< Sampling interval of the background thread
+        double low_pressure = 1.0;                ///< some avg10 (%) below which Low is possible
+        double elevated_pressure = 10.0;          ///< some avg10 (%) entering Elevated
+        double critical_pressure = 40.0;          ///< some avg10 (%) entering Critical
+        double critical_full_pressure = 10.0;     ///< full avg10 (%) entering Critical
+        double low_usage = 0.5;                   ///< Usage of the limit below which Low is possible
+        double elevated_usage = 0.8;              ///< Usage of the limit entering Elevated
+        double critical_usage = 0.95;             ///< Usage of the limit entering Critical
+        size_t recovery_samples = 3;              ///< Consecutive samples at a lower state needed to relax
+        size_t history = 32;                      ///< Transitions kept in the stats
+        std::array<double, 4> budget_scale = {2.0, 1.0, 0.5, 0.125};                         ///< Sink budgets
+        std::array<Level, 4> shed_level = {Level::Trace, Level::Trace, Level::Info, Level::Warn}; ///< Shedding
+    };
+
+    /**
+     * @brief A change of pressure state, kept in the stats and reported to the transition callback
+     */
+    struct MemoryTransition {
+        MemoryPressure from;                        ///< Previous state
+        MemoryPressure to;                          ///< New state
+        MemorySample sample;                        ///< Sample that completed the transition
+        std::chrono::system_clock::time_point time; ///< When the transition happened
+    };
+
+    /**
+     * @brief Snapshot of a memory governor's state
+     */
+    struct MemoryGovernorStats {
+        MemoryPressure state = MemoryPressure::Normal; ///< Current state
+        double budget_scale = 1.0;                     ///< Budget scale applied to the sinks
+        Level shed_level = Level::Trace;               ///< Records below this level are dropped
+        uint64_t samples = 0;                          ///< Samples taken
+        uint64_t read_errors = 0;                      ///< Samples for which no file could be read
+        uint64_t escalations = 0;                      ///< Transitions to a higher pressure state
+        uint64_t relaxations = 0;                      ///< Transitions to a lower pressure state
+        MemorySample last;                             ///< Most recent sample
+        std::vector<MemoryTransition> transitions;     ///< Recent transitions, oldest first
+    };
+
+    namespace detail {
+
+        inline bool read_small_file(const std::string &path, std::string &out) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                return false;
+            }
+            out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            return true;
+        }
+
+        /**
+         * @brief Read avg10 of the "some" or "full" line of a PSI file
+         */
+        inline bool parse_psi_avg10(const std::string &text, const std::string &kind, double &out) {
+            std::string key = kind + " avg10=";
+            size_t pos = text.find(key);
+            while (pos != std::string::npos && pos != 0 && text[pos - 1] != '\n') {
+                pos = text.find(key, pos + 1);
+            }
+            if (pos == std::string::npos) {
+                return false;
+            }
+            out = std::strtod(text.c_str() + pos + key.size(), nullptr);
+            return true;
+        }
+
+        /**
+         * @brief Read memory.high or memory.max ("max" or a missing file = no limit, 0)
+         */
+        inline uint64_t read_memory_limit(const std::string &path) {
+            std::string text;
+            if (!read_small_file(path, text) || text.compare(0, 3, "max") == 0) {
+                return 0;
+            }
+            return std::strtoull(text.c_str(), nullptr, 10);
+        }
+
+        /**
+         * @brief cgroup v2 directory of this process, from /proc/self/cgroup ("0::/path")
+         */
+        inline std::string default_cgroup_dir() {
+            const std::string root = "/sys/fs/cgroup";
+            std::string self;
+            if (!read_small_file("/proc/self/cgroup", self)) {
+                return root;
+            }
+            size_t pos = self.find("0::");
+            while (pos != std::string::npos && pos != 0 && self[pos - 1] != '\n') {
+                pos = self.find("0::", pos + 1);
+            }
+            if (pos == std::string::npos) {
+                return root;
+            }
+            size_t end = self.find('\n', pos);
+            std::string relative = self.substr(pos + 3, end == std::string::npos ? end : end - pos - 3);
+            std::string dir = relative == "/" ? root : root + relative;
+            std::string probe;
+            return read_small_file(dir + "/memory.current", probe) ? dir : root;
+        }
+
+        /**
+         * @brief Read the memory files of a cgroup directory
+         */
+        inline MemorySample read_memory_sample(const std::string &dir) {
+            MemorySample sample;
+            std::string text;
+            if (read_small_file(dir + "/memory.pressure", text)) {
+                sample.valid = true;
+                parse_psi_avg10(text, "some", sample.some_avg10);
+                parse_psi_avg10(text, "full", sample.full_avg10);
+            }
+            if (read_small_file(dir + "/memory.current", text)) {
+                sample.valid = true;
+                sample.current = std::strtoull(text.c_str(), nullptr, 10);
+            }
+            uint64_t high = read_memory_limit(dir + "/memory.high");
+            uint64_t max = read_memory_limit(dir + "/memory.max");
+            sample.limit = (high && max) ? std::min(high, max) : (high ? high : max);
+            return sample;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Adapts sink budgets and level shedding to memory pressure
+     *
+     * Either start() a background thread sampling every options.interval, or
+     * call poll() from an existing housekeeping loop. stop() (and the
+     * destructor) restores the configured budgets and stops shedding.
+     *
+     * Example:
+     *   echo::MemoryGovernor governor;
+     *   governor.set_transition_callback([](const echo::MemoryTransition &t) {
+     *       echo::warn("memory pressure: ", echo::memory_pressure_name(t.to));
+     *   });
+     *   governor.start();
+     *
+     * The transition callback runs on the sampling thread without any echo
+     * lock held, so it may log.
+     */
+    class MemoryGovernor {
+      public:
+        using TransitionCallback = std::function<void(const MemoryTransition &)>;
+
+      private:
+        MemoryGovernorOptions options_;
+        std::string dir_;
+        MemoryPressure state_ = MemoryPressure::Normal;
+        MemoryPressure pending_ = MemoryPressure::Normal; // Lower state waiting for recovery_samples
+        size_t pending_samples_ = 0;
+        MemoryGovernorStats stats_;
+        TransitionCallback on_transition_;
+        bool running_ = false;
+        std::thread thread_;
+        std::condition_variable wake_;
+        mutable std::mutex mutex_;
+
+        static size_t index(MemoryPressure pressure) { return static_cast<size_t>(pressure); }
+
+        /**
+         * @brief State a sample calls for, before hysteresis
+         */
+        [[nodiscard]] MemoryPressure classify(const MemorySample &sample) const {
+            if (!sample.valid) {
+                return MemoryPressure::Normal;
+            }
+            double usage = sample.usage();
+            if (sample.some_avg10 >= options_.critical_pressure ||
+                sample.full_avg10 >= options_.critical_full_pressure ||
+                (sample.limit && usage >= options_.critical_usage)) {
+                return MemoryPressure::Critical;
+            }
+            if (sample.some_avg10 >= options_.elevated_pressure || (sample.limit && usage >= options_.elevated_usage)) {
+                return MemoryPressure::Elevated;
+            }
+            if (sample.limit && usage < options_.low_usage && sample.some_avg10 < options_.low_pressure) {
+                return MemoryPressure::Low;
+            }
+            return MemoryPressure::Normal;
+        }
+
+        /**
+         * @brief Apply a state's budget and shed level (caller holds mutex_)
+         */
+        void apply(MemoryPressure state) {
+            stats_.budget_scale = options_.budget_scale[index(state)];
+            stats_.shed_level = options_.shed_level[index(state)];
+            detail::get_shed_level().store(stats_.shed_level, std::memory_order_relaxed);
+            detail::SinkRegistry::instance().set_memory_budget_all(stats_.budget_scale);
+        }
+
+        void run() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (running_) {
+                lock.unlock();
+                poll();
+                lock.lock();
+                wake_.wait_for(lock, options_.interval, [this] { return !running_; });
+            }
+        }
+
+      public:
+        /**
+         * @brief Create a governor (no sample is taken until poll() or start())
+         * @param options Thresholds, cgroup directory and per-state reactions
+         */
+        explicit MemoryGovernor(MemoryGovernorOptions options = {})
+            : options_(std::move(options)),
+              dir_(options_.cgroup_dir.empty() ? detail::default_cgroup_dir() : options_.cgroup_dir) {}
+
+        ~MemoryGovernor() { stop(); }
+
+        // Prevent copying
+        MemoryGovernor(const MemoryGovernor &) = delete;
+        MemoryGovernor &operator=(const MemoryGovernor &) = delete;
+
+        /**
+         * @brief Start sampling on a background thread
+         */
+        void start() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (running_) {
+                return;
+            }
+            running_ = true;
+            thread_ = std::thread([this] { run(); });
+        }
+
+        /**
+         * @brief Stop the background thread and restore the configured budgets and levels
+         */
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                running_ = false;
+            }
+            wake_.notify_all();
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (state_ != MemoryPressure::Normal) {
+                state_ = MemoryPressure::Normal;
+                pending_ = MemoryPressure::Normal;
+                pending_samples_ = 0;
+                stats_.state = state_;
+                apply(state_);
+            }
+        }
+
+        /**
+         * @brief Take one sample and apply any resulting transition
+         * @return State after the sample
+         */
+        MemoryPressure poll() {
+            MemorySample sample = detail::read_memory_sample(dir_);
+            MemoryTransition transition{};
+            TransitionCallback callback;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.samples;
+                stats_.read_errors += sample.valid ? 0 : 1;
+                stats_.last = sample;
+
+                MemoryPressure target = classify(sample);
+                MemoryPressure next = state_;
+                if (target > state_) {
+                    next = target;
+                    pending_samples_ = 0;
+                } else if (target < state_) {
+                    // Relax to the highest state seen during the recovery period
+                    pending_ = pending_samples_ == 0 ? target : std::max(pending_, target);
+                    if (++pending_samples_ >= options_.recovery_samples) {
+                        next = pending_;
+                        pending_samples_ = 0;
+                    }
+                } else {
+                    pending_samples_ = 0;
+                }
+
+                if (next == state_) {
+                    return state_;
+                }
+                transition = {state_, next, sample, std::chrono::system_clock::now()};
+                (next > state_ ? stats_.escalations : stats_.relaxations)++;
+                state_ = next;
+                stats_.state = next;
+                stats_.transitions.push_back(transition);
+                if (stats_.transitions.size() > options_.history) {
+                    stats_.transitions.erase(stats_.transitions.begin());
+                }
+                apply(next);
+                callback = on_transition_;
+            }
+            if (callback) {
+                callback(transition);
+            }
+            return transition.to;
+        }
+
+        /**
+         * @brief Set a callback invoked on every state transition
+         */
+        void set_transition_callback(TransitionCallback callback) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            on_transition_ = std::move(callback);
+        }
+
+        /**
+         * @brief Get the current pressure state
+         */
+        [[nodiscard]] MemoryPressure state() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return state_;
+        }
+
+        /**
+         * @brief Get a snapshot of the state, counters and recent transitions
+         */
+        [[nodiscard]] MemoryGovernorStats stats() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return stats_;
+        }
+
+        /**
+         * @brief Get the directory the memory files are read from
+         */
+        [[nodiscard]] const std::string &cgroup_dir() const noexcept { return dir_; }
+    };
+
+} // namespace echo
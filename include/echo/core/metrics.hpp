@@ -0,0 +1,694 @@
+#pragma once
+
+/**
+ * @file core/metrics.hpp
+ * @brief In-process aggregation of numeric fields from structured log records
+ *
+ * Many records exist only to be counted or summed downstream, e.g.
+ * echo::info("request ", echo::kv("status", code, "bytes", n)). A metric rule
+ * selects records by category and/or message prefix (the literal text at the
+ * call site), pulls "key=value" fields out of them, and aggregates:
+ * - counters keyed by a field value (e.g. requests per status)
+ * - sums of numeric fields
+ * - gauges (last value of a numeric field)
+ * - histograms with fixed bucket bounds
+ *
+ * Aggregation runs on per-thread state before the record is formatted or the
+ * log mutex is taken. Matching records can be dropped, so a hot path that
+ * logs one line per request costs one parse instead of one write per sink.
+ *
+ * Aggregates are read with metrics_snapshot(), or emitted as one summary
+ * record per rule (category "metrics") by emit_metrics() or periodically.
+ * Only records that pass the global and category level filters are seen.
+ *
+ * Example:
+ *   echo::MetricRule rule;
+ *   rule.name = "http";
+ *   rule.category = "http";
+ *   rule.count_by = {"status"};
+ *   rule.sums = {"bytes"};
+ *   rule.histograms = {{"ms", {1, 10, 100}}};
+ *   rule.drop_original = true;
+ *   echo::add_metric_rule(rule);
+ *   echo::set_metrics_options({.interval = std::chrono::seconds(10)});
+ *
+ *   echo::category("http").info(echo::kv("status", 200, "bytes", 512, "ms", 3));
+ *   // every 10s: [info] [metrics] http records=... status.200=... bytes.sum=... ms.le_1=...
+ */
+
+#include <echo/core/level.hpp>
+#include <echo/core/mutex.hpp>
+#include <echo/core/proxy.hpp>
+#include <echo/filters/category.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace echo {
+
+    /**
+     * @brief Histogram over one numeric field
+     */
+    struct MetricHistogram {
+        std::string field;          ///< Field name
+        std::vector<double> bounds; ///< Upper bucket bounds (sorted on add); values above the last go to "inf"
+    };
+
+    /**
+     * @brief Which records to aggregate and which fields to extract
+     */
+    struct MetricRule {
+        std::string name;     ///< Name in snapshots and summary records
+        std::string category; ///< Category pattern ("" = any record, "app.*" wildcards allowed)
+        std::string prefix;   ///< Message prefix identifying the call site ("" = any)
+
+        std::vector<std::string> count_by;       ///< Count records per distinct value of these fields
+        std::vector<std::string> sums;           ///< Sum these numeric fields
+        std::vector<std::string> gauges;         ///< Keep the last value of these numeric fields
+        std::vector<MetricHistogram> histograms; ///< Bucket these numeric fields
+
+        bool drop_original = false; ///< Consume matching records instead of writing them
+    };
+
+    /**
+     * @brief Histogram state in a snapshot
+     */
+    struct HistogramSnapshot {
+        std::vector<double> bounds;    ///< Upper bucket bounds
+        std::vector<uint64_t> buckets; ///< Per-bucket counts; one more than bounds (last is "inf")
+        uint64_t count = 0;            ///< Values observed
+        double sum = 0.0;              ///< Sum of values
+        double min = 0.0;              ///< Smallest value (valid if count > 0)
+        double max = 0.0;              ///< Largest value (valid if count > 0)
+    };
+
+    /**
+     * @brief Aggregates of one rule since the last emission or reset
+     */
+    struct MetricSnapshot {
+        std::string name;     ///< Rule name
+        uint64_t records = 0; ///< Records matched
+        uint64_t dropped = 0; ///< Matched records consumed instead of written
+
+        std::map<std::string, std::map<std::string, uint64_t>> counters; ///< field -> value -> count
+        std::map<std::string, double> sums;                              ///< field -> sum (fields seen at least once)
+        std::map<std::string, double> gauges;                            ///< field -> last value
+        std::map<std::string, HistogramSnapshot> histograms;             ///< field -> histogram
+    };
+
+    /**
+     * @brief Summary emission settings
+     */
+    struct MetricsOptions {
+        std::chrono::milliseconds interval{0}; ///< Emit summaries this often (0 = only on emit_metrics())
+        Level level = Level::Info;             ///< Level of summary records
+        std::string category = "metrics";      ///< Category of summary records (filtering and "[tag] ")
+        bool emit_empty = false;               ///< Also emit rules that matched nothing in the interval
+    };
+
+    namespace detail {
+
+        /**
+         * @brief Aggregates of one rule, laid out by the rule's field indices
+         */
+        struct RuleAggregate {
+            uint64_t records = 0;
+            uint64_t dropped = 0;
+            std::vector<std::map<std::string, uint64_t, std::less<>>> counters; // per count_by field
+            std::vector<double> sums;
+            std::vector<uint64_t> sum_counts;
+            std::vector<double> gauges;
+            std::vector<int64_t> gauge_stamps; // steady_clock ns of the last update; 0 = never set
+            std::vector<HistogramSnapshot> histograms;
+
+            explicit RuleAggregate(const MetricRule &rule)
+                : counters(rule.count_by.size()), sums(rule.sums.size(), 0.0), sum_counts(rule.sums.size(), 0),
+                  gauges(rule.gauges.size(), 0.0), gauge_stamps(rule.gauges.size(), 0),
+                  histograms(rule.histograms.size()) {
+                for (size_t i = 0; i < rule.histograms.size(); ++i) {
+                    histograms[i].bounds = rule.histograms[i].bounds;
+                    histograms[i].buckets.assign(rule.histograms[i].bounds.size() + 1, 0);
+                }
+            }
+
+            [[nodiscard]] bool empty() const { return records == 0; }
+
+            void merge_from(const RuleAggregate &other) {
+                records += other.records;
+                dropped += other.dropped;
+                for (size_t i = 0; i < counters.size(); ++i) {
+                    for (const auto &[value, count] : other.counters[i]) {
+                        counters[i][value] += count;
+                    }
+                }
+                for (size_t i = 0; i < sums.size(); ++i) {
+                    sums[i] += other.sums[i];
+                    sum_counts[i] += other.sum_counts[i];
+                }
+                for (size_t i = 0; i < gauges.size(); ++i) {
+                    if (other.gauge_stamps[i] > gauge_stamps[i]) {
+                        gauges[i] = other.gauges[i];
+                        gauge_stamps[i] = other.gauge_stamps[i];
+                    }
+                }
+                for (size_t i = 0; i < histograms.size(); ++i) {
+                    HistogramSnapshot &h = histograms[i];
+                    const HistogramSnapshot &o = other.histograms[i];
+                    if (o.count == 0) {
+                        continue;
+                    }
+                    for (size_t b = 0; b < h.buckets.size(); ++b) {
+                        h.buckets[b] += o.buckets[b];
+                    }
+                    h.min = h.count == 0 ? o.min : std::min(h.min, o.min);
+                    h.max = h.count == 0 ? o.max : std::max(h.max, o.max);
+                    h.count += o.count;
+                    h.sum += o.sum;
+                }
+            }
+
+            void reset() {
+                records = dropped = 0;
+                for (auto &c : counters) {
+                    c.clear();
+                }
+                std::fill(sums.begin(), sums.end(), 0.0);
+                std::fill(sum_counts.begin(), sum_counts.end(), 0);
+                // Gauges keep their stamps so a newer value still wins the next merge
+                for (auto &h : histograms) {
+                    std::fill(h.buckets.begin(), h.buckets.end(), 0);
+                    h.count = 0;
+                    h.sum = h.min = h.max = 0.0;
+                }
+            }
+        };
+
+        /// Rules are replaced as a whole; a generation number identifies each set
+        struct MetricRuleSet {
+            uint64_t generation = 0;
+            std::vector<MetricRule> rules;
+        };
+
+        /**
+         * @brief One thread's aggregates; locked by its owner per record and by collectors
+         */
+        struct ThreadMetrics {
+            std::mutex mutex;
+            uint64_t generation = 0;
+            std::vector<RuleAggregate> aggregates;
+        };
+
+        /**
+         * @brief Parse the "key=value" tokens of a message into a reusable list
+         *
+         * A value starting with a double quote runs to the next unescaped quote, as
+         * written by kv() for values with spaces; the view is the text between the
+         * quotes, escapes included.
+         */
+        inline void parse_fields(std::string_view message,
+                                 std::vector<std::pair<std::string_view, std::string_view>> &fields) {
+            fields.clear();
+            size_t pos = 0;
+            while (pos < message.size()) {
+                size_t end = message.find(' ', pos);
+                if (end == std::string_view::npos) {
+                    end = message.size();
+                }
+                size_t eq = message.find('=', pos);
+                if (eq < end && eq > pos && eq + 1 < message.size() && message[eq + 1] == '"') {
+                    size_t close = eq + 2;
+                    while (close < message.size() && message[close] != '"') {
+                        close += message[close] == '\\' ? 2 : 1;
+                    }
+                    close = std::min(close, message.size()); // Unterminated: the rest of the message
+                    fields.emplace_back(message.substr(pos, eq - pos), message.substr(eq + 2, close - eq - 2));
+                    pos = close + 1;
+                    continue;
+                }
+                std::string_view token = message.substr(pos, end - pos);
+                eq = token.find('=');
+                if (eq != std::string_view::npos && eq > 0) {
+                    fields.emplace_back(token.substr(0, eq), token.substr(eq + 1));
+                }
+                pos = end + 1;
+            }
+        }
+
+        inline const std::string_view *
+        find_field(const std::vector<std::pair<std::string_view, std::string_view>> &fields, std::string_view key) {
+            for (const auto &field : fields) {
+                if (field.first == key) {
+                    return &field.second;
+                }
+            }
+            return nullptr;
+        }
+
+        inline bool parse_number(std::string_view text, double &out) {
+            if (!text.empty() && text.front() == '+') {
+                text.remove_prefix(1);
+            }
+            auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+            return ec == std::errc() && ptr == text.data() + text.size();
+        }
+
+        inline void append_number(std::string &out, double value) {
+            char buffer[32];
+            auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, ec == std::errc() ? static_cast<size_t>(ptr - buffer) : 0);
+        }
+
+        inline void append_number(std::string &out, uint64_t value) { out += std::to_string(value); }
+
+        inline int64_t metrics_now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        /**
+         * @brief Summary record text for one snapshot
+         *
+         * "<name> records=N [dropped=N] f.value=N f.sum=X f.last=X f.count=N f.sum=X f.min=X f.max=X f.le_B=N
+         * f.le_inf=N" - histogram buckets are cumulative, as their "le" (less or equal) names say.
+         */
+        inline std::string format_metric_summary(const MetricSnapshot &snapshot) {
+            std::string out = snapshot.name;
+            out += " records=";
+            append_number(out, snapshot.records);
+            if (snapshot.dropped > 0) {
+                out += " dropped=";
+                append_number(out, snapshot.dropped);
+            }
+            for (const auto &[field, values] : snapshot.counters) {
+                for (const auto &[value, count] : values) {
+                    out += ' ';
+                    out += field;
+                    out += '.';
+                    out += value;
+                    out += '=';
+                    append_number(out, count);
+                }
+            }
+            for (const auto &[field, sum] : snapshot.sums) {
+                out += ' ';
+                out += field;
+                out += ".sum=";
+                append_number(out, sum);
+            }
+            for (const auto &[field, value] : snapshot.gauges) {
+                out += ' ';
+                out += field;
+                out += ".last=";
+                append_number(out, value);
+            }
+            for (const auto &[field, h] : snapshot.histograms) {
+                out += ' ' + field + ".count=";
+                append_number(out, h.count);
+                if (h.count == 0) {
+                    continue;
+                }
+                out += ' ' + field + ".sum=";
+                append_number(out, h.sum);
+                out += ' ' + field + ".min=";
+                append_number(out, h.min);
+                out += ' ' + field + ".max=";
+                append_number(out, h.max);
+                uint64_t cumulative = 0;
+                for (size_t b = 0; b < h.buckets.size(); ++b) {
+                    cumulative += h.buckets[b];
+                    out += ' ' + field + ".le_";
+                    if (b < h.bounds.size()) {
+                        append_number(out, h.bounds[b]);
+                    } else {
+                        out += "inf";
+                    }
+                    out += '=';
+                    append_number(out, cumulative);
+                }
+            }
+            return out;
+        }
+
+        /**
+         * @brief Owns the rules, every thread's aggregates, and the running totals
+         */
+        class MetricsRegistry {
+          private:
+            mutable std::mutex mutex_;
+            std::shared_ptr<const MetricRuleSet> rules_ = std::make_shared<MetricRuleSet>();
+            std::atomic<uint64_t> generation_{0};
+            std::vector<std::shared_ptr<ThreadMetrics>> threads_;
+            std::vector<RuleAggregate> totals_; // Collected from threads, laid out like rules_
+            MetricsOptions options_;
+            std::atomic<int64_t> interval_ns_{0};
+            std::atomic<int64_t> next_emit_ns_{0};
+
+            MetricsRegistry() = default;
+
+            /// Fold every thread's aggregates into totals_ (mutex_ held)
+            void collect_locked() {
+                for (const auto &thread : threads_) {
+                    std::lock_guard<std::mutex> lock(thread->mutex);
+                    if (thread->generation == rules_->generation) {
+                        for (size_t i = 0; i < thread->aggregates.size() && i < totals_.size(); ++i) {
+                            totals_[i].merge_from(thread->aggregates[i]);
+                            thread->aggregates[i].reset();
+                        }
+                    }
+                }
+            }
+
+            MetricSnapshot snapshot_of(size_t index) const {
+                const MetricRule &rule = rules_->rules[index];
+                const RuleAggregate &agg = totals_[index];
+                MetricSnapshot s;
+                s.name = rule.name;
+                s.records = agg.records;
+                s.dropped = agg.dropped;
+                for (size_t i = 0; i < rule.count_by.size(); ++i) {
+                    auto &values = s.counters[rule.count_by[i]];
+                    for (const auto &[value, count] : agg.counters[i]) {
+                        values[value] += count;
+                    }
+                }
+                for (size_t i = 0; i < rule.sums.size(); ++i) {
+                    if (agg.sum_counts[i] > 0) {
+                        s.sums[rule.sums[i]] = agg.sums[i];
+                    }
+                }
+                for (size_t i = 0; i < rule.gauges.size(); ++i) {
+                    if (agg.gauge_stamps[i] != 0) {
+                        s.gauges[rule.gauges[i]] = agg.gauges[i];
+                    }
+                }
+                for (size_t i = 0; i < rule.histograms.size(); ++i) {
+                    s.histograms[rule.histograms[i].field] = agg.histograms[i];
+                }
+                return s;
+            }
+
+            void publish(std::shared_ptr<MetricRuleSet> rules) {
+                rules_ = std::move(rules);
+                generation_.store(rules_->generation, std::memory_order_release);
+                get_record_observer().store(rules_->rules.empty() ? nullptr : &MetricsRegistry::observe,
+                                            std::memory_order_release);
+            }
+
+            /**
+             * @brief This thread's aggregates, registered on first use and folded into the totals at thread exit
+             */
+            ThreadMetrics &thread_state() {
+                struct Holder {
+                    std::shared_ptr<ThreadMetrics> state = std::make_shared<ThreadMetrics>();
+                    Holder() { MetricsRegistry::instance().attach(state); }
+                    ~Holder() { MetricsRegistry::instance().detach(state); }
+                };
+                thread_local Holder holder;
+                return *holder.state;
+            }
+
+            void attach(const std::shared_ptr<ThreadMetrics> &state) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                threads_.push_back(state);
+            }
+
+            void detach(const std::shared_ptr<ThreadMetrics> &state) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                {
+                    std::lock_guard<std::mutex> state_lock(state->mutex);
+                    if (state->generation == rules_->generation) {
+                        for (size_t i = 0; i < state->aggregates.size() && i < totals_.size(); ++i) {
+                            totals_[i].merge_from(state->aggregates[i]);
+                        }
+                    }
+                }
+                threads_.erase(std::remove(threads_.begin(), threads_.end(), state), threads_.end());
+            }
+
+            std::shared_ptr<const MetricRuleSet> current_rules() {
+                thread_local std::shared_ptr<const MetricRuleSet> cached;
+                if (!cached || cached->generation != generation_.load(std::memory_order_acquire)) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    cached = rules_;
+                }
+                return cached;
+            }
+
+            /**
+             * @brief Record observer installed while rules exist; returns true to drop the record
+             */
+            static bool observe(Level level, const std::string *category, const std::string &message) {
+                (void)level;
+                MetricsRegistry &registry = instance();
+                std::shared_ptr<const MetricRuleSet> rules = registry.current_rules();
+
+                thread_local std::vector<std::pair<std::string_view, std::string_view>> fields;
+                bool parsed = false;
+                bool matched = false;
+                bool drop = false;
+
+                ThreadMetrics &state = registry.thread_state();
+                {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    if (state.generation != rules->generation) {
+                        state.aggregates.clear();
+                        state.generation = rules->generation;
+                    }
+                    while (state.aggregates.size() < rules->rules.size()) {
+                        state.aggregates.emplace_back(rules->rules[state.aggregates.size()]);
+                    }
+
+                    for (size_t r = 0; r < rules->rules.size(); ++r) {
+                        const MetricRule &rule = rules->rules[r];
+                        if (!rule.category.empty() &&
+                            (!category || !CategoryRegistry::matches_pattern(rule.category, *category))) {
+                            continue;
+                        }
+                        if (!rule.prefix.empty() && message.compare(0, rule.prefix.size(), rule.prefix) != 0) {
+                            continue;
+                        }
+                        if (!parsed) {
+                            parse_fields(message, fields);
+                            parsed = true;
+                        }
+                        matched = true;
+                        update(state.aggregates[r], rule, fields);
+                        if (rule.drop_original) {
+                            ++state.aggregates[r].dropped;
+                            drop = true;
+                        }
+                    }
+                }
+
+                if (matched) {
+                    registry.maybe_emit();
+                }
+                return drop;
+            }
+
+            static void update(RuleAggregate &agg, const MetricRule &rule,
+                               const std::vector<std::pair<std::string_view, std::string_view>> &fields) {
+                ++agg.records;
+                for (size_t i = 0; i < rule.count_by.size(); ++i) {
+                    if (const std::string_view *value = find_field(fields, rule.count_by[i])) {
+                        auto &values = agg.counters[i];
+                        auto it = values.find(*value);
+                        if (it == values.end()) {
+                            it = values.emplace(std::string(*value), 0).first;
+                        }
+                        ++it->second;
+                    }
+                }
+                double number = 0.0;
+                for (size_t i = 0; i < rule.sums.size(); ++i) {
+                    const std::string_view *value = find_field(fields, rule.sums[i]);
+                    if (value && parse_number(*value, number)) {
+                        agg.sums[i] += number;
+                        ++agg.sum_counts[i];
+                    }
+                }
+                for (size_t i = 0; i < rule.gauges.size(); ++i) {
+                    const std::string_view *value = find_field(fields, rule.gauges[i]);
+                    if (value && parse_number(*value, number)) {
+                        agg.gauges[i] = number;
+                        agg.gauge_stamps[i] = metrics_now_ns();
+                    }
+                }
+                for (size_t i = 0; i < rule.histograms.size(); ++i) {
+                    const std::string_view *value = find_field(fields, rule.histograms[i].field);
+                    if (!value || !parse_number(*value, number)) {
+                        continue;
+                    }
+                    HistogramSnapshot &h = agg.histograms[i];
+                    size_t bucket = static_cast<size_t>(
+                        std::lower_bound(h.bounds.begin(), h.bounds.end(), number) - h.bounds.begin());
+                    ++h.buckets[bucket];
+                    h.min = h.count == 0 ? number : std::min(h.min, number);
+                    h.max = h.count == 0 ? number : std::max(h.max, number);
+                    ++h.count;
+                    h.sum += number;
+                }
+            }
+
+            void maybe_emit() {
+                int64_t interval = interval_ns_.load(std::memory_order_relaxed);
+                if (interval <= 0) {
+                    return;
+                }
+                int64_t now = metrics_now_ns();
+                int64_t next = next_emit_ns_.load(std::memory_order_relaxed);
+                if (now >= next && next_emit_ns_.compare_exchange_strong(next, now + interval)) {
+                    emit();
+                }
+            }
+
+          public:
+            static MetricsRegistry &instance() {
+                static MetricsRegistry registry;
+                return registry;
+            }
+
+            void add_rule(MetricRule rule) {
+                for (auto &h : rule.histograms) {
+                    std::sort(h.bounds.begin(), h.bounds.end());
+                    h.bounds.erase(std::unique(h.bounds.begin(), h.bounds.end()), h.bounds.end());
+                }
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                collect_locked();
+                auto next = std::make_shared<MetricRuleSet>(*rules_);
+                next->generation = rules_->generation + 1;
+                next->rules.push_back(std::move(rule));
+                totals_.emplace_back(next->rules.back());
+                publish(std::move(next));
+            }
+
+            void clear_rules() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto next = std::make_shared<MetricRuleSet>();
+                next->generation = rules_->generation + 1;
+                totals_.clear();
+                publish(std::move(next));
+            }
+
+            void set_options(MetricsOptions options) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                int64_t interval = std::chrono::duration_cast<std::chrono::nanoseconds>(options.interval).count();
+                options_ = std::move(options);
+                interval_ns_.store(interval, std::memory_order_relaxed);
+                next_emit_ns_.store(metrics_now_ns() + interval, std::memory_order_relaxed);
+            }
+
+            std::vector<MetricSnapshot> snapshot() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                collect_locked();
+                std::vector<MetricSnapshot> result;
+                result.reserve(totals_.size());
+                for (size_t i = 0; i < totals_.size(); ++i) {
+                    result.push_back(snapshot_of(i));
+                }
+                return result;
+            }
+
+            void reset() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                collect_locked();
+                for (auto &agg : totals_) {
+                    agg.reset();
+                }
+            }
+
+            /**
+             * @brief Log one summary record per rule and reset the aggregates
+             */
+            void emit() {
+                std::vector<std::string> lines;
+                Level level;
+                std::string category;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    collect_locked();
+                    level = options_.level;
+                    category = options_.category;
+                    for (size_t i = 0; i < totals_.size(); ++i) {
+                        if (!totals_[i].empty() || options_.emit_empty) {
+                            lines.push_back('[' + category + "] " + format_metric_summary(snapshot_of(i)));
+                        }
+                        totals_[i].reset();
+                    }
+                }
+
+                // Summaries go straight to the sinks, never back through the record observer
+                if (lines.empty() || static_cast<int>(level) < static_cast<int>(ACTIVE_LEVEL) ||
+                    !CategoryRegistry::instance().should_log(category, level)) {
+                    return;
+                }
+                std::string &formatted = thread_format_buffer();
+                std::lock_guard<std::mutex> lock(get_log_mutex());
+                for (const auto &line : lines) {
+                    formatted.clear();
+                    append_log_message(formatted, level, line, "", false);
+                    get_sink_writer()(level, formatted);
+                }
+            }
+        };
+
+    } // namespace detail
+
+    // =================================================================================================
+    // Public API
+    // =================================================================================================
+
+    /**
+     * @brief Start aggregating records that match a rule
+     *
+     * Histogram bounds are sorted. Rules are checked in the order added; a
+     * record can feed several rules.
+     */
+    inline void add_metric_rule(MetricRule rule) { detail::MetricsRegistry::instance().add_rule(std::move(rule)); }
+
+    /**
+     * @brief Remove all rules and discard their aggregates; records flow unchanged again
+     */
+    inline void clear_metric_rules() { detail::MetricsRegistry::instance().clear_rules(); }
+
+    /**
+     * @brief Configure summary records (interval, level, category)
+     *
+     * Periodic summaries are emitted by whichever thread logs the first
+     * matching record after the interval elapses; no background thread runs.
+     */
+    inline void set_metrics_options(MetricsOptions options) {
+        detail::MetricsRegistry::instance().set_options(std::move(options));
+    }
+
+    /**
+     * @brief Aggregates of every rule since the last emission or reset
+     */
+    [[nodiscard]] inline std::vector<MetricSnapshot> metrics_snapshot() {
+        return detail::MetricsRegistry::instance().snapshot();
+    }
+
+    /**
+     * @brief Log one summary record per rule now and reset the aggregates
+     */
+    inline void emit_metrics() { detail::MetricsRegistry::instance().emit(); }
+
+    /**
+     * @brief Zero the aggregates without emitting them
+     */
+    inline void reset_metrics() { detail::MetricsRegistry::instance().reset(); }
+
+} // namespace echo
@@ -84,6 +84,19 @@ namespace echo {
             return false; // Not enough time has passed
         }
 
+        /**
+         * @brief Pre-size the .once() and .every() tables
+         * @param call_sites Expected number of distinct call sites
+         *
+         * Avoids rehashing (and the allocation spike that comes with it) the first
+         * time a new call site is seen on a hot path.
+         */
+        inline void reserve_rate_limit_tables(size_t call_sites) {
+            std::lock_guard<std::mutex> lock(get_log_mutex());
+            get_once_set().reserve(call_sites);
+            get_every_map().reserve(call_sites);
+        }
+
     } // namespace detail
 } // namespace echo
 
@@ -5,12 +5,14 @@
  * @brief Proxy classes for fluent logging interface
  */
 
+#include <echo/core/console.hpp>
 #include <echo/core/formatter.hpp>
 #include <echo/core/level.hpp>
 #include <echo/core/mutex.hpp>
 #include <echo/core/once.hpp>
 #include <echo/core/timestamp.hpp>
 
+#include <atomic>
 #include <iostream>
 #include <mutex>
 #include <sstream>
@@ -29,57 +31,87 @@ namespace echo {
         // Forward declare sink registry access
         SinkRegistry &get_sink_registry();
 
-        // Format a log message with level, timestamp, and color
-        inline std::string format_log_message(Level level, const std::string &message, const std::string &color_code,
-                                              bool inplace) {
-            std::ostringstream oss;
+        /**
+         * @brief Per-thread scratch buffer for formatted log lines
+         *
+         * Reused across calls so steady-state formatting does not allocate.
+         * thread_warm_up() pre-sizes it.
+         */
+        inline std::string &thread_format_buffer() {
+            thread_local std::string buffer;
+            return buffer;
+        }
 
+        // Append a log message with level, timestamp, and color
+        inline void append_log_message(std::string &out, Level level, const std::string &message,
+                                       const std::string &color_code, bool inplace) {
             // Clear line if inplace
             if (inplace) {
-                oss << "\r\033[K"; // \r = carriage return, \033[K = clear to end of line
+                out += "\r\033[K"; // \r = carriage return, \033[K = clear to end of line
             }
 
 #ifdef ECHO_ENABLE_TIMESTAMP
-            oss << "[" << get_timestamp() << "]";
+            out += '[';
+            out += get_timestamp();
+            out += ']';
 #endif
-            oss << level_color(level) << "[" << level_name(level) << "]" << RESET << " ";
+            out += level_color(level);
+            out += '[';
+            out += level_name(level);
+            out += ']';
+            out += RESET;
+            out += ' ';
 
             if (!color_code.empty()) {
-                oss << color_code << message << RESET;
+                out += color_code;
+                out += message;
+                out += RESET;
             } else {
-                oss << message;
+                out += message;
             }
 
             // Only add newline if not inplace
             if (!inplace) {
-                oss << "\n";
+                out += '\n';
             }
-
-            return oss.str();
         }
 
-        // Format a simple print message (no level)
-        inline std::string format_print_message(const std::string &message, const std::string &color_code,
-                                                bool inplace) {
-            std::ostringstream oss;
-
+        // Append a simple print message (no level)
+        inline void append_print_message(std::string &out, const std::string &message, const std::string &color_code,
+                                         bool inplace) {
             // Clear line if inplace
             if (inplace) {
-                oss << "\r\033[K"; // \r = carriage return, \033[K = clear to end of line
+                out += "\r\033[K"; // \r = carriage return, \033[K = clear to end of line
             }
 
             if (!color_code.empty()) {
-                oss << color_code << message << RESET;
+                out += color_code;
+                out += message;
+                out += RESET;
             } else {
-                oss << message;
+                out += message;
             }
 
             // Only add newline if not inplace
             if (!inplace) {
-                oss << "\n";
+                out += '\n';
             }
+        }
 
-            return oss.str();
+        // Format a log message with level, timestamp, and color
+        inline std::string format_log_message(Level level, const std::string &message, const std::string &color_code,
+                                              bool inplace) {
+            std::string result;
+            append_log_message(result, level, message, color_code, inplace);
+            return result;
+        }
+
+        // Format a simple print message (no level)
+        inline std::string format_print_message(const std::string &message, const std::string &color_code,
+                                                bool inplace) {
+            std::string result;
+            append_print_message(result, message, color_code, inplace);
+            return result;
         }
     } // namespace detail
 
@@ -100,6 +132,7 @@ namespace echo {
       private:
         std::string message_;
         std::string color_code_;
+        const std::string *category_ = nullptr; // Set by category_log_proxy, which owns the string
         bool skip_print_ = false;
         bool inplace_ = false;
 
@@ -107,14 +140,31 @@ namespace echo {
         template <typename... Args> log_proxy(const Args &...args) {
             // Only build message if it will be printed (compile-time check)
             if constexpr (static_cast<int>(L) >= static_cast<int>(detail::ACTIVE_LEVEL)) {
-                message_ = detail::build_message(args...);
+                // Records below the runtime or shed level cost no conversion or allocation
+                if (static_cast<int>(L) < static_cast<int>(detail::get_effective_level())) {
+                    skip_print_ = true;
+                    return;
+                }
+                message_ = detail::build_message_bounded(
+                    detail::get_max_record_size().load(std::memory_order_relaxed), args...);
+            }
+        }
+
+        // Build the message under an explicit size cap (internal - used by category_log_proxy)
+        template <typename... Args> log_proxy(detail::RecordCap cap, const Args &...args) {
+            if constexpr (static_cast<int>(L) >= static_cast<int>(detail::ACTIVE_LEVEL)) {
+                if (cap.filtered || static_cast<int>(L) < static_cast<int>(detail::get_effective_level())) {
+                    skip_print_ = true;
+                    return;
+                }
+                message_ = detail::build_message_bounded(cap.bytes, args...);
             }
         }
 
         // Move semantics - allow moving but prevent copying
         log_proxy(log_proxy &&other) noexcept
             : message_(std::move(other.message_)), color_code_(std::move(other.color_code_)),
-              skip_print_(other.skip_print_), inplace_(other.inplace_) {
+              category_(other.category_), skip_print_(other.skip_print_), inplace_(other.inplace_) {
             other.skip_print_ = true; // Prevent moved-from object from printing
         }
 
@@ -122,6 +172,7 @@ namespace echo {
             if (this != &other) {
                 message_ = std::move(other.message_);
                 color_code_ = std::move(other.color_code_);
+                category_ = other.category_;
                 skip_print_ = other.skip_print_;
                 inplace_ = other.inplace_;
                 other.skip_print_ = true;
@@ -237,6 +288,12 @@ namespace echo {
             return *this;
         }
 
+        // Attach the category the record was logged under (internal - used by category_log_proxy)
+        log_proxy &category_impl(const std::string &category) {
+            category_ = &category;
+            return *this;
+        }
+
         // Destructor performs the actual logging
         ~log_proxy(); // Defined after SinkRegistry is complete
     };
@@ -258,7 +315,10 @@ namespace echo {
         bool inplace_ = false;
 
       public:
-        template <typename... Args> print_proxy(const Args &...args) { message_ = detail::build_message(args...); }
+        template <typename... Args> print_proxy(const Args &...args) {
+            message_ = detail::build_message_bounded(detail::get_max_record_size().load(std::memory_order_relaxed),
+                                                     args...);
+        }
 
         // Move semantics - allow moving but prevent copying
         print_proxy(print_proxy &&other) noexcept
@@ -444,13 +504,13 @@ namespace echo {
         // Fallback implementations
         inline void fallback_write_to_sinks(Level level, const std::string &formatted_message) {
             // Fallback: write directly to stdout/stderr if no sinks are available
-            std::ostream &out = (level >= Level::Error) ? std::cerr : std::cout;
+            std::ostream &out = (level >= Level::Error) ? console_err() : console_out();
             out << formatted_message << std::flush;
         }
 
         inline void fallback_write_print_to_sinks(const std::string &formatted_message) {
             // Fallback: write directly to stdout if no sinks are available
-            std::cout << formatted_message << std::flush;
+            console_out() << formatted_message << std::flush;
         }
 
         // Function pointers (initialized to fallback, will be overridden by registry.hpp)
@@ -463,6 +523,20 @@ namespace echo {
             static PrintWriterFunc writer = fallback_write_print_to_sinks;
             return writer;
         }
+
+        /**
+         * @brief Sees each record that passed the level filters, before formatting
+         *
+         * Receives the record's category (nullptr if none) and unformatted
+         * message; returning true consumes the record so it is not written.
+         * Installed by metrics.hpp while metric rules exist.
+         */
+        using RecordObserverFunc = bool (*)(Level, const std::string *, const std::string &);
+
+        inline std::atomic<RecordObserverFunc> &get_record_observer() {
+            static std::atomic<RecordObserverFunc> observer{nullptr};
+            return observer;
+        }
     } // namespace detail
 
     // log_proxy destructor implementation
@@ -478,8 +552,17 @@ namespace echo {
                 return;
             }
 
-            // Format the message once
-            std::string formatted = detail::format_log_message(L, message_, color_code_, inplace_);
+            // Metric extraction may consume the record before it costs any formatting or I/O
+            if (auto observe = detail::get_record_observer().load(std::memory_order_acquire)) {
+                if (observe(L, category_, message_)) {
+                    return;
+                }
+            }
+
+            // Format the message once into the per-thread buffer
+            std::string &formatted = detail::thread_format_buffer();
+            formatted.clear();
+            detail::append_log_message(formatted, L, message_, color_code_, inplace_);
 
             // Write to all registered sinks (thread-safe)
             std::lock_guard<std::mutex> lock(detail::get_log_mutex());
@@ -494,8 +577,10 @@ namespace echo {
             return;
         }
 
-        // Format the message once
-        std::string formatted = detail::format_print_message(message_, color_code_, inplace_);
+        // Format the message once into the per-thread buffer
+        std::string &formatted = detail::thread_format_buffer();
+        formatted.clear();
+        detail::append_print_message(formatted, message_, color_code_, inplace_);
 
         // Write to all registered sinks (thread-safe)
         std::lock_guard<std::mutex> lock(detail::get_log_mutex());
@@ -559,7 +644,7 @@ namespace echo {
         if constexpr (static_cast<int>(L) >= static_cast<int>(detail::ACTIVE_LEVEL)) {
             if (static_cast<int>(L) >= static_cast<int>(detail::get_effective_level())) {
                 std::lock_guard<std::mutex> lock(detail::get_log_mutex());
-                std::ostream &out = (L >= Level::Error) ? std::cerr : std::cout;
+                std::ostream &out = (L >= Level::Error) ? detail::console_err() : detail::console_out();
                 out << detail::level_color(L) << "[" << detail::level_name(L) << "]" << detail::RESET << " " << msg
                     << " [" << loc.file_name() << ":" << loc.line() << " " << loc.function_name() << "]\n";
             }
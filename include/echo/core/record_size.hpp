@@ -0,0 +1,334 @@
+#pragma once
+
+/**
+ * @file core/record_size.hpp
+ * @brief Record size caps: bounded appends and the truncation marker
+ *
+ * A cap limits how many bytes of a record are built, not just written: once
+ * the cap is reached, build_message() stops converting arguments and the
+ * formatters stop copying the message. std::format and operator<< output is
+ * produced for at most the cap plus a lookahead of a few caps, so an
+ * accidental multi-MB dump costs O(cap) on the hot path. pretty(), print()
+ * and to_string() return a finished string and still run in full; only the
+ * part that fits is copied. The kept text is followed by a marker carrying
+ * the original size, e.g. "... [truncated: 5242880 bytes]" (">N" when
+ * formatting stopped before the end was known).
+ *
+ * Caps exist per logger (global, per category) and per sink/formatter.
+ * 0 means unlimited, the default.
+ */
+
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace echo {
+
+    namespace detail {
+
+        /**
+         * @brief Global record size cap in bytes (0 = unlimited)
+         */
+        inline std::atomic<size_t> &get_max_record_size() {
+            static std::atomic<size_t> cap{0};
+            return cap;
+        }
+
+        /**
+         * @brief Cap for one record (passed to log_proxy by category loggers)
+         */
+        struct RecordCap {
+            size_t bytes = 0;      ///< 0 = unlimited
+            bool filtered = false; ///< Dropped by the category level: build nothing
+        };
+
+        /**
+         * @brief Largest n' <= n that does not split a UTF-8 sequence of text
+         */
+        inline size_t utf8_prefix(std::string_view text, size_t n) {
+            if (n >= text.size()) {
+                return text.size();
+            }
+            size_t cut = n;
+            // Step back over continuation bytes (at most 3 for valid UTF-8)
+            while (cut > 0 && n - cut < 3 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) {
+                --cut;
+            }
+            return (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80 ? n : cut;
+        }
+
+        /**
+         * @brief Append "... [truncated: N bytes]" (or ">N" for a lower bound)
+         */
+        inline void append_truncation_marker(std::string &out, size_t total, bool lower_bound) {
+            out += "... [truncated: ";
+            if (lower_bound) {
+                out += '>';
+            }
+            char digits[24];
+            auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), total);
+            out.append(digits, static_cast<size_t>(end - digits));
+            out += " bytes]";
+        }
+
+        /**
+         * @brief Appends pieces of one record until a byte budget is used up
+         *
+         * Keeps counting the size of what is offered after the budget is
+         * exhausted (for the marker); callers stop producing pieces once full()
+         * and mark the total as a lower bound with give_up().
+         */
+        class BoundedAppender {
+          private:
+            std::string &out_;
+            size_t budget_;
+            size_t total_ = 0;
+            bool truncated_ = false;
+            bool lower_bound_ = false;
+
+          public:
+            BoundedAppender(std::string &out, size_t budget) : out_(out), budget_(budget) {}
+
+            /// Bytes that can still be kept
+            [[nodiscard]] size_t room() const { return total_ < budget_ ? budget_ - total_ : 0; }
+
+            /// Budget used up: further pieces are only counted
+            [[nodiscard]] bool full() const { return truncated_ || total_ >= budget_; }
+
+            /// Size of everything offered so far
+            [[nodiscard]] size_t total() const { return total_; }
+
+            /// The cap this appender enforces
+            [[nodiscard]] size_t budget() const { return budget_; }
+
+            void append(std::string_view piece) { append(piece, piece.size()); }
+
+            /// Append a piece that is the first part of something full_size bytes long
+            void append(std::string_view piece, size_t full_size) {
+                size_t keep = room();
+                if (piece.size() > keep || full_size > keep) {
+                    out_.append(piece.data(), utf8_prefix(piece, keep));
+                    truncated_ = truncated_ || full_size > keep;
+                } else {
+                    out_.append(piece.data(), piece.size());
+                }
+                total_ += full_size;
+            }
+
+            /// Count bytes that were not produced at all
+            void skip(size_t bytes) {
+                total_ += bytes;
+                truncated_ = truncated_ || bytes > 0;
+            }
+
+            /// Stop without knowing the full size: the marker reports a lower bound
+            void give_up() {
+                truncated_ = true;
+                lower_bound_ = true;
+            }
+
+            /// Append the marker if anything was cut
+            void finish() {
+                if (truncated_) {
+                    append_truncation_marker(out_, total_, lower_bound_);
+                }
+            }
+        };
+
+        /**
+         * @brief streambuf feeding a BoundedAppender, for operator<< output
+         *
+         * After the budget is used up, output is counted for up to another
+         * `lookahead` bytes for the size estimate; then the stream is failed so
+         * well-behaved inserters stop early.
+         */
+        class BoundedStreamBuf : public std::streambuf {
+          private:
+            BoundedAppender &appender_;
+            size_t limit_;
+
+          protected:
+            int_type overflow(int_type ch) override {
+                if (traits_type::eq_int_type(ch, traits_type::eof())) {
+                    return traits_type::not_eof(ch);
+                }
+                char c = traits_type::to_char_type(ch);
+                return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+            }
+
+            std::streamsize xsputn(const char *s, std::streamsize n) override {
+                if (appender_.total() >= limit_) {
+                    appender_.give_up();
+                    return 0;
+                }
+                appender_.append(std::string_view(s, static_cast<size_t>(n)));
+                return n;
+            }
+
+          public:
+            BoundedStreamBuf(BoundedAppender &appender, size_t lookahead)
+                : appender_(appender), limit_(appender.total() + appender.room() + lookahead) {}
+        };
+
+        /// Thrown through std::format by BoundedFormatBuffer to stop a formatter past its lookahead
+        struct BoundedFormatStop {};
+
+        /**
+         * @brief Output buffer feeding a BoundedAppender, for std::format output
+         *
+         * Characters are collected in small pieces and handed to the appender.
+         * Once the appender has seen `lookahead` bytes past the budget, the
+         * iterator throws BoundedFormatStop: std::format cannot be stopped any
+         * other way. Without exceptions the rest is only counted.
+         */
+        class BoundedFormatBuffer {
+          private:
+            BoundedAppender &appender_;
+            size_t limit_;
+            char piece_[256];
+            size_t used_ = 0;
+
+          public:
+            /// Output iterator for std::format_to()
+            class iterator {
+              private:
+                BoundedFormatBuffer *buffer_ = nullptr;
+
+              public:
+                using difference_type = std::ptrdiff_t;
+
+                iterator() = default;
+                explicit iterator(BoundedFormatBuffer &buffer) : buffer_(&buffer) {}
+
+                iterator &operator=(char c) {
+                    buffer_->put(c);
+                    return *this;
+                }
+                iterator &operator*() { return *this; }
+                iterator &operator++() { return *this; }
+                iterator operator++(int) { return *this; }
+            };
+
+            BoundedFormatBuffer(BoundedAppender &appender, size_t lookahead)
+                : appender_(appender), limit_(appender.total() + appender.room() + lookahead) {}
+
+            [[nodiscard]] iterator out() { return iterator(*this); }
+
+            void put(char c) {
+                piece_[used_++] = c;
+                if (used_ == sizeof(piece_)) {
+                    flush();
+#if defined(__cpp_exceptions)
+                    if (appender_.total() >= limit_) {
+                        throw BoundedFormatStop{};
+                    }
+#endif
+                }
+            }
+
+            /// Hand the buffered characters to the appender
+            void flush() {
+                appender_.append(std::string_view(piece_, used_));
+                used_ = 0;
+            }
+        };
+
+        /**
+         * @brief Length of an ANSI escape sequence starting at text[pos] (0 if none)
+         */
+        inline size_t ansi_sequence_length(std::string_view text, size_t pos) {
+            if (text[pos] != '\033' || pos + 1 >= text.size() || text[pos + 1] != '[') {
+                return 0;
+            }
+            size_t end = pos + 2;
+            while (end < text.size() && !(text[end] >= 0x40 && text[end] <= 0x7E)) {
+                ++end;
+            }
+            return end < text.size() ? end + 1 - pos : text.size() - pos;
+        }
+
+        /**
+         * @brief Offset in text after its first cap visible bytes, and the visible size of all of text
+         *
+         * ANSI escape sequences do not count towards the cap and are never split.
+         */
+        inline size_t visible_prefix(std::string_view text, size_t cap, size_t &visible_total) {
+            size_t cut = text.size();
+            visible_total = 0;
+            for (size_t pos = 0; pos < text.size();) {
+                if (size_t escape = ansi_sequence_length(text, pos)) {
+                    pos += escape;
+                    continue;
+                }
+                if (visible_total == cap && cut == text.size()) {
+                    cut = pos;
+                }
+                ++visible_total;
+                ++pos;
+            }
+            return cut;
+        }
+
+        /**
+         * @brief Whether a formatted line (newline and colors excluded) is longer than cap (0 = unlimited)
+         */
+        inline bool exceeds_record_size(std::string_view text, size_t cap) {
+            size_t size = !text.empty() && text.back() == '\n' ? text.size() - 1 : text.size();
+            if (cap == 0 || size <= cap) {
+                return false; // Fast path: cannot have more visible bytes than bytes
+            }
+            size_t visible = 0;
+            visible_prefix(text.substr(0, size), cap, visible);
+            return visible > cap;
+        }
+
+        /**
+         * @brief Cut an already formatted line to cap visible bytes plus the marker
+         * @param text Formatted line (may end with '\n', may contain ANSI codes)
+         * @param cap Visible bytes of text to keep
+         * @param out Receives the shortened line (replaced)
+         *
+         * Keeps the trailing newline and resets colors if the kept part has any.
+         */
+        inline void truncate_record(std::string_view text, size_t cap, std::string &out) {
+            out.clear();
+            bool newline = !text.empty() && text.back() == '\n';
+            std::string_view body = newline ? text.substr(0, text.size() - 1) : text;
+            size_t visible = 0;
+            size_t cut = visible_prefix(body, cap, visible);
+            std::string_view kept = body.substr(0, utf8_prefix(body, cut));
+            out.append(kept.data(), kept.size());
+            if (kept.find('\033') != std::string_view::npos) {
+                out += "\033[0m";
+            }
+            append_truncation_marker(out, visible, false);
+            if (newline) {
+                out += '\n';
+            }
+        }
+
+    } // namespace detail
+
+    // =================================================================================================
+    // Public API
+    // =================================================================================================
+
+    /**
+     * @brief Cap the size of every log message, enforced while it is built
+     * @param bytes Maximum message bytes before the truncation marker (0 = unlimited)
+     *
+     * Example:
+     *   echo::set_max_record_size(16 * 1024);
+     *   echo::info("payload: ", body);  // "[info] payload: {...... [truncated: 5242889 bytes]"
+     */
+    inline void set_max_record_size(size_t bytes) { detail::get_max_record_size().store(bytes); }
+
+    /**
+     * @brief Get the global record size cap (0 = unlimited)
+     */
+    [[nodiscard]] inline size_t get_max_record_size() { return detail::get_max_record_size().load(); }
+
+} // namespace echo
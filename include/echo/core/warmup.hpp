@@ -0,0 +1,117 @@
+#pragma once
+
+/**
+ * @file core/warmup.hpp
+ * @brief Explicit warm-up of lazily initialized logging state
+ *
+ * The first log call in a process (and the first one on each thread) pays for
+ * several one-time steps: registry and default sink construction, reading
+ * LOGLEVEL/ECHOLEVEL from the environment, timezone loading, hash table growth
+ * in the .once()/.every() tables, and growth of the per-thread format buffer.
+ *
+ * Call echo::warm_up() during startup, and echo::thread_warm_up() at the start
+ * of each latency-sensitive thread, to move that cost out of the critical path.
+ *
+ * Example:
+ *   int main() {
+ *       echo::add_sink(std::make_shared<echo::FileSink>("app.log"));
+ *       echo::warm_up();
+ *
+ *       std::thread worker([] {
+ *           echo::thread_warm_up();
+ *           // ... hot loop ...
+ *       });
+ *   }
+ */
+
+#include <echo/core/formatter.hpp>
+#include <echo/core/level.hpp>
+#include <echo/core/once.hpp>
+#include <echo/core/proxy.hpp>
+#include <echo/core/timestamp.hpp>
+#include <echo/filters/category.hpp>
+#include <echo/sinks/registry.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace echo {
+
+    namespace detail {
+        /// Default capacity of the per-thread format buffer after warm-up
+        constexpr size_t WARM_UP_BUFFER_SIZE = 4096;
+
+        /// Default number of .once()/.every() call sites to reserve room for
+        constexpr size_t WARM_UP_CALL_SITES = 1024;
+
+        /// Stack depth pre-faulted by thread_warm_up()
+        constexpr size_t WARM_UP_STACK_SIZE = 32 * 1024;
+
+        /**
+         * @brief Touch every page of a stack region so later calls do not fault
+         */
+        [[gnu::noinline]] inline void prefault_stack() {
+#if defined(__GNUC__) || defined(__clang__)
+            char stack[WARM_UP_STACK_SIZE];
+            for (size_t i = 0; i < WARM_UP_STACK_SIZE; i += 4096) {
+                stack[i] = 0;
+            }
+            // Make the stores observable so they are neither elided nor warned about as unused
+            asm volatile("" : : "r"(stack) : "memory");
+#else
+            volatile char stack[WARM_UP_STACK_SIZE];
+            for (size_t i = 0; i < WARM_UP_STACK_SIZE; i += 4096) {
+                stack[i] = 0;
+            }
+#endif
+        }
+    } // namespace detail
+
+    /**
+     * @brief Eagerly initialize per-thread logging state for the calling thread
+     * @param buffer_size Capacity to reserve for the per-thread format buffer
+     *
+     * Reserves and pre-faults the thread's format buffer and the top of its stack.
+     * Safe to call more than once; later calls only grow the buffer.
+     */
+    inline void thread_warm_up(size_t buffer_size = detail::WARM_UP_BUFFER_SIZE) {
+        std::string &buffer = detail::thread_format_buffer();
+        if (buffer.capacity() < buffer_size) {
+            buffer.reserve(buffer_size);
+        }
+        // Writing the whole capacity forces the pages to be mapped now
+        buffer.assign(buffer.capacity(), '\0');
+        buffer.clear();
+
+        detail::prefault_stack();
+    }
+
+    /**
+     * @brief Eagerly initialize all lazily constructed logging state
+     * @param call_sites Expected number of distinct .once()/.every() call sites
+     *
+     * Initializes the runtime level (environment lookup), the sink registry and
+     * default sink, each sink's own lazy state (see Sink::warm_up(), e.g. the
+     * NetworkSink connection), the category registry, the .once()/.every() tables,
+     * the timestamp/timezone path, and the calling thread's state.
+     *
+     * Nothing is written to any sink. Call after registering sinks, so that their
+     * warm-up runs too.
+     */
+    inline void warm_up(size_t call_sites = detail::WARM_UP_CALL_SITES) {
+        (void)detail::get_effective_level();
+        (void)detail::CategoryRegistry::instance();
+        detail::SinkRegistry::instance().warm_up();
+        detail::reserve_rate_limit_tables(call_sites);
+
+#ifdef ECHO_ENABLE_TIMESTAMP
+        (void)detail::get_timestamp();
+#endif
+
+        // Exercise the conversion paths used by build_message()
+        (void)detail::build_message("", 0, 0.0);
+
+        thread_warm_up();
+    }
+
+} // namespace echo
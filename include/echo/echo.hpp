@@ -17,9 +17,15 @@
  *   -DECHO_ENABLE_SYSLOG_SINK    - Enable syslog integration (Unix only)
  *   -DECHO_ENABLE_NETWORK_SINK   - Enable TCP/UDP logging
  *   -DECHO_ENABLE_NULL_SINK      - Enable null sink (for testing)
+ *   -DECHO_ENABLE_FAILOVER_SINK  - Enable failover chains with latency SLOs
+ *   -DECHO_ENABLE_RELIABLE_UDP_SINK - Enable UDP logging with NACK retransmit (Unix only)
  *
  * ConsoleSink is ALWAYS available (default).
  *
+ * Low-footprint profile for constrained targets:
+ *   -DECHO_FREESTANDING          - Only echo/freestanding.hpp: callback output, static
+ *                                  buffer, no iostream/exceptions/heap (no sinks or widgets)
+ *
  * Usage:
  *   #include <echo/echo.hpp>
  *
@@ -33,6 +39,13 @@
  *   #endif
  */
 
+#ifdef ECHO_FREESTANDING
+
+// Low-footprint profile: everything else is compiled out
+#include <echo/freestanding.hpp>
+
+#else
+
 // Core components (always included)
 #include <echo/core/formatter.hpp>
 #include <echo/core/level.hpp>
@@ -68,13 +81,37 @@
 #include <echo/sinks/null_sink.hpp>
 #endif
 
+#ifdef ECHO_ENABLE_FAILOVER_SINK
+#include <echo/sinks/failover_sink.hpp>
+#endif
+
+#ifdef ECHO_ENABLE_RELIABLE_UDP_SINK
+#include <echo/sinks/reliable_udp_sink.hpp>
+#endif
+
 // Formatters (always included)
+#include <echo/formatters/batch.hpp>
 #include <echo/formatters/custom.hpp>
 #include <echo/formatters/formatter.hpp>
 #include <echo/formatters/pattern.hpp>
 
 // Filters (always included)
 #include <echo/filters/category.hpp>
+
+// Warm-up (needs sinks and filters)
+#include <echo/core/warmup.hpp>
+
+// Multi-line blocks (needs sinks)
+#include <echo/core/block.hpp>
+
+// Foreign stdout/stderr capture (needs sinks and filters)
+#include <echo/core/capture.hpp>
+
+// Metrics from structured fields (needs sinks and filters)
+#include <echo/core/metrics.hpp>
+
+// Memory-pressure governor for sink budgets and level shedding (needs sinks)
+#include <echo/core/memory_governor.hpp>
 // TODO: Created in future tasks
 // #include <echo/filters/level.hpp>
 // #include <echo/filters/composite.hpp>
@@ -92,6 +129,8 @@
 // Widgets (existing - keep as is for now, will split later)
 #include <echo/widget.hpp>
 
+#endif // ECHO_FREESTANDING
+
 namespace echo {
 // All components are now available
 
@@ -20,12 +20,15 @@
 
 #include <echo/core/level.hpp>
 #include <echo/core/mutex.hpp>
+#include <echo/core/record_size.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -41,15 +44,18 @@ namespace echo {
           private:
             // Map of category name to log level
             std::unordered_map<std::string, Level> category_levels_;
+            std::unordered_map<std::string, size_t> record_caps_;
+            std::atomic<bool> has_record_caps_{false}; // Lets uncapped loggers skip the lock
             mutable std::mutex mutex_;
 
+          public:
             /**
              * @brief Check if a pattern matches a category name
              * @param pattern Pattern with optional wildcard (e.g., "app.*")
              * @param category Category name to match
              * @return true if pattern matches
              */
-            static bool matches_pattern(const std::string &pattern, const std::string &category) {
+            static bool matches_pattern(std::string_view pattern, std::string_view category) {
                 // Exact match
                 if (pattern == category) {
                     return true;
@@ -57,7 +63,7 @@ namespace echo {
 
                 // Wildcard match: "app.*" matches "app.network", "app.network.tcp", etc.
                 if (pattern.size() >= 2 && pattern.substr(pattern.size() - 2) == ".*") {
-                    std::string prefix = pattern.substr(0, pattern.size() - 2);
+                    std::string_view prefix = pattern.substr(0, pattern.size() - 2);
                     // Match if category starts with prefix and has a dot after it
                     if (category.size() > prefix.size() && category.substr(0, prefix.size()) == prefix &&
                         (category[prefix.size()] == '.' || category.size() == prefix.size())) {
@@ -68,15 +74,19 @@ namespace echo {
                 return false;
             }
 
+          private:
             /**
-             * @brief Find the most specific matching level for a category
+             * @brief Find the most specific setting for a category
+             * @param settings Settings keyed by category name or pattern
              * @param category Category name
-             * @return Level if found, nullopt otherwise
+             * @return Setting if found, nullopt otherwise
              */
-            std::optional<Level> find_matching_level(const std::string &category) const {
+            template <typename Map>
+            static std::optional<typename Map::mapped_type> find_matching(const Map &settings,
+                                                                           const std::string &category) {
                 // First, try exact match
-                auto it = category_levels_.find(category);
-                if (it != category_levels_.end()) {
+                auto it = settings.find(category);
+                if (it != settings.end()) {
                     return it->second;
                 }
 
@@ -92,22 +102,46 @@ namespace echo {
                     current = current.substr(0, last_dot);
                     std::string pattern = current + ".*";
 
-                    it = category_levels_.find(pattern);
-                    if (it != category_levels_.end()) {
+                    it = settings.find(pattern);
+                    if (it != settings.end()) {
                         return it->second;
                     }
                 }
 
                 // Finally, try wildcard patterns
-                for (const auto &[pattern, level] : category_levels_) {
+                for (const auto &[pattern, value] : settings) {
                     if (matches_pattern(pattern, category)) {
-                        return level;
+                        return value;
                     }
                 }
 
                 return std::nullopt;
             }
 
+            /**
+             * @brief Find the most specific matching level for a category
+             * @param category Category name
+             * @return Level if found, nullopt otherwise
+             */
+            std::optional<Level> find_matching_level(const std::string &category) const {
+                return find_matching(category_levels_, category);
+            }
+
+            // should_log() with mutex_ held
+            bool should_log_locked(const std::string &category, Level level) const {
+                // Get category-specific level
+                auto cat_level = find_matching_level(category);
+                if (cat_level.has_value()) {
+                    // Shedding under memory pressure overrides category levels too
+                    Level shed = get_shed_level().load(std::memory_order_relaxed);
+                    return static_cast<int>(level) >= static_cast<int>(cat_level.value()) &&
+                           static_cast<int>(level) >= static_cast<int>(shed);
+                }
+
+                // No category-specific level, use global level
+                return static_cast<int>(level) >= static_cast<int>(get_effective_level());
+            }
+
           public:
             /**
              * @brief Get the singleton instance
@@ -145,15 +179,28 @@ namespace echo {
              */
             bool should_log(const std::string &category, Level level) const {
                 std::lock_guard<std::mutex> lock(mutex_);
+                return should_log_locked(category, level);
+            }
 
-                // Get category-specific level
-                auto cat_level = find_matching_level(category);
-                if (cat_level.has_value()) {
-                    return static_cast<int>(level) >= static_cast<int>(cat_level.value());
+            /**
+             * @brief should_log() and max_record_size() for one record, under a single lock
+             * @param category Category name
+             * @param level Log level
+             * @return Cap for the record; filtered when it should not be logged
+             */
+            RecordCap record_cap(const std::string &category, Level level) const {
+                RecordCap cap;
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!should_log_locked(category, level)) {
+                    cap.filtered = true;
+                    return cap;
                 }
-
-                // No category-specific level, use global level
-                return static_cast<int>(level) >= static_cast<int>(get_effective_level());
+                std::optional<size_t> bytes;
+                if (has_record_caps_.load(std::memory_order_relaxed)) {
+                    bytes = find_matching(record_caps_, category);
+                }
+                cap.bytes = bytes ? *bytes : get_max_record_size().load(std::memory_order_relaxed);
+                return cap;
             }
 
             /**
@@ -164,6 +211,41 @@ namespace echo {
                 category_levels_.clear();
             }
 
+            /**
+             * @brief Set the record size cap for a category
+             * @param category Category name (supports wildcards like "app.*")
+             * @param bytes Maximum message bytes (0 = unlimited, overriding the global cap)
+             */
+            void set_max_record_size(const std::string &category, size_t bytes) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                record_caps_[category] = bytes;
+                has_record_caps_.store(true, std::memory_order_release);
+            }
+
+            /**
+             * @brief Record size cap for a category, falling back to the global cap
+             * @param category Category name
+             * @return Maximum message bytes (0 = unlimited)
+             */
+            size_t max_record_size(const std::string &category) const {
+                if (has_record_caps_.load(std::memory_order_acquire)) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (auto cap = find_matching(record_caps_, category)) {
+                        return *cap;
+                    }
+                }
+                return get_max_record_size().load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Clear all category record size caps
+             */
+            void clear_max_record_sizes() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                record_caps_.clear();
+                has_record_caps_.store(false, std::memory_order_release);
+            }
+
             /**
              * @brief Get all registered categories
              * @return Vector of category names
@@ -213,6 +295,24 @@ namespace echo {
      */
     inline void clear_category_levels() { detail::CategoryRegistry::instance().clear(); }
 
+    /**
+     * @brief Cap the message size of a category's records
+     * @param category Category name (supports wildcards like "app.*")
+     * @param bytes Maximum message bytes (0 = unlimited, overriding set_max_record_size())
+     *
+     * Example:
+     *   echo::set_max_record_size(4096);
+     *   echo::set_category_max_record_size("http.body", 64 * 1024);
+     */
+    inline void set_category_max_record_size(const std::string &category, size_t bytes) {
+        detail::CategoryRegistry::instance().set_max_record_size(category, bytes);
+    }
+
+    /**
+     * @brief Clear all category record size caps
+     */
+    inline void clear_category_max_record_sizes() { detail::CategoryRegistry::instance().clear_max_record_sizes(); }
+
     /**
      * @brief Get all registered categories
      * @return Vector of category names
@@ -248,23 +348,27 @@ namespace echo {
     template <Level L> class category_log_proxy {
       private:
         std::string category_;
-        log_proxy<L> proxy_;
         bool should_log_;
+        log_proxy<L> proxy_;
+
+        template <typename... Args>
+        category_log_proxy(detail::RecordCap cap, std::string &&category, const Args &...args)
+            : category_(std::move(category)), should_log_(!cap.filtered), proxy_(cap, args...) {
+            proxy_.category_impl(category_);
+        }
 
       public:
+        // The level and the cap are resolved in one registry lookup, before the record is built
         template <typename... Args>
         category_log_proxy(std::string category, const Args &...args)
-            : category_(std::move(category)), proxy_(args...), should_log_(true) {
-            // Check if this category should log at this level
-            if (!detail::CategoryRegistry::instance().should_log(category_, L)) {
-                should_log_ = false;
-            }
-        }
+            : category_log_proxy(detail::CategoryRegistry::instance().record_cap(category, L), std::move(category),
+                                 args...) {}
 
         // Move semantics
         category_log_proxy(category_log_proxy &&other) noexcept
-            : category_(std::move(other.category_)), proxy_(std::move(other.proxy_)), should_log_(other.should_log_) {
+            : category_(std::move(other.category_)), should_log_(other.should_log_), proxy_(std::move(other.proxy_)) {
             other.should_log_ = false;
+            proxy_.category_impl(category_); // Point at our copy of the name, not the moved-from one
         }
 
         // Prevent copying
@@ -0,0 +1,473 @@
+#pragma once
+
+/**
+ * @file formatters/batch.hpp
+ * @brief Batch rendering of structure-of-arrays record batches
+ *
+ * Rendering records one at a time repeats the same work per record: a
+ * timestamp conversion, a level name lookup, a small append per field.
+ * RecordBatch keeps a batch's timestamps, levels and category IDs in
+ * separate arrays with the message bodies back to back in one buffer.
+ * BatchRenderer then renders the whole batch in passes:
+ * 1. split every timestamp into seconds-of-day and sub-second parts
+ * 2. convert those to "HH:MM:SS.mmm" text for 8 records at a time (AVX2)
+ * 3. size the output once, then copy level and category prefixes from
+ *    precomputed tables and the message bodies into it
+ *
+ * The result is one contiguous LogBlock per batch, so sinks receive one
+ * write per batch (see Sink::write_block) instead of one per record.
+ *
+ * Line layout, matching the default console output and
+ * PatternFormatter("[{time}][{level}] {msg}"):
+ *   [12:34:56.789][info] [category] message\n
+ *
+ * The AVX2 kernel is used when compiled with -mavx2 and ECHO_SIMD_DISABLED
+ * is not defined; otherwise a scalar kernel produces the same bytes.
+ *
+ * Example:
+ *   echo::BatchRenderer renderer;
+ *   uint16_t net = renderer.add_category("net");
+ *
+ *   echo::RecordBatch batch;
+ *   batch.push(echo::Level::Info, net, "connected");
+ *   batch.push(echo::Level::Warn, echo::RecordBatch::NO_CATEGORY, "slow");
+ *
+ *   echo::LogBlock block;
+ *   renderer.render(batch, block);
+ *   file_sink->write_block(block);
+ */
+
+#include <echo/core/level.hpp>
+#include <echo/sinks/sink.hpp>
+
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__) && !defined(ECHO_SIMD_DISABLED)
+#define ECHO_BATCH_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace echo {
+
+    /**
+     * @brief Records of one batch in structure-of-arrays form
+     *
+     * Message bodies are stored back to back in messages; ends[i] is the
+     * offset one past record i's message. A batch holds at most 4 GiB of text.
+     */
+    struct RecordBatch {
+        static constexpr uint16_t NO_CATEGORY = 0xFFFF; ///< Category ID of records without a category
+
+        std::vector<int64_t> timestamps;  ///< Nanoseconds since the Unix epoch (system_clock)
+        std::vector<Level> levels;        ///< Level of each record
+        std::vector<uint16_t> categories; ///< BatchRenderer category ID of each record
+        std::vector<uint32_t> ends;       ///< End offset of each message in messages
+        std::string messages;             ///< Message bodies, concatenated
+
+        /**
+         * @brief Append a record with an explicit timestamp
+         */
+        void push(int64_t timestamp_ns, Level level, uint16_t category, std::string_view message) {
+            timestamps.push_back(timestamp_ns);
+            levels.push_back(level);
+            categories.push_back(category);
+            messages.append(message);
+            ends.push_back(static_cast<uint32_t>(messages.size()));
+        }
+
+        /**
+         * @brief Append a record stamped with the current time
+         */
+        void push(Level level, uint16_t category, std::string_view message) {
+            auto now = std::chrono::system_clock::now().time_since_epoch();
+            push(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(), level, category, message);
+        }
+
+        /**
+         * @brief Message body of record i
+         */
+        [[nodiscard]] std::string_view message(size_t i) const {
+            uint32_t begin = i == 0 ? 0 : ends[i - 1];
+            return std::string_view(messages).substr(begin, ends[i] - begin);
+        }
+
+        /**
+         * @brief Pre-size for a number of records and bytes of message text
+         */
+        void reserve(size_t records, size_t bytes) {
+            timestamps.reserve(records);
+            levels.reserve(records);
+            categories.reserve(records);
+            ends.reserve(records);
+            messages.reserve(bytes);
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return levels.size(); }
+        [[nodiscard]] bool empty() const noexcept { return levels.empty(); }
+
+        void clear() noexcept {
+            timestamps.clear();
+            levels.clear();
+            categories.clear();
+            ends.clear();
+            messages.clear();
+        }
+    };
+
+    /**
+     * @brief Sub-second digits of rendered timestamps
+     */
+    enum class TimestampPrecision {
+        None,    ///< No timestamp field
+        Seconds, ///< HH:MM:SS
+        Millis,  ///< HH:MM:SS.mmm
+        Micros   ///< HH:MM:SS.uuuuuu
+    };
+
+    /**
+     * @brief Options for BatchRenderer
+     */
+    struct BatchRendererOptions {
+        TimestampPrecision precision = TimestampPrecision::Millis; ///< Timestamp field
+        bool utc = false;                                          ///< UTC instead of local time
+        bool color = false; ///< Colored level prefixes (as on the console); FileSink strips them
+    };
+
+    namespace detail {
+
+        /// Bytes per row of the clock kernel's output: "HH:MM:SS.mmmuuu" plus one pad byte
+        inline constexpr size_t CLOCK_ROW = 16;
+
+        /**
+         * @brief Scalar clock kernel: one 16-byte text row per record
+         *
+         * Uses the same multiply-shift divisions as the AVX2 kernel (exact for
+         * the value ranges involved), so both produce identical bytes.
+         */
+        inline void render_clock_rows_scalar(const uint32_t *sod, const uint32_t *ms, const uint32_t *us,
+                                             size_t count, char *rows) {
+            auto two = [](char *p, uint32_t v) {
+                uint32_t tens = (v * 103) >> 10;
+                p[0] = static_cast<char>('0' + tens);
+                p[1] = static_cast<char>('0' + (v - tens * 10));
+            };
+            auto three = [&](char *p, uint32_t v) {
+                uint32_t hundreds = (v * 41) >> 12;
+                p[0] = static_cast<char>('0' + hundreds);
+                two(p + 1, v - hundreds * 100);
+            };
+            for (size_t i = 0; i < count; ++i) {
+                char *row = rows + i * CLOCK_ROW;
+                uint32_t h = (sod[i] * 37283) >> 27;
+                uint32_t rem = sod[i] - h * 3600;
+                uint32_t m = (rem * 34953) >> 21;
+                two(row, h);
+                row[2] = ':';
+                two(row + 3, m);
+                row[5] = ':';
+                two(row + 6, rem - m * 60);
+                row[8] = '.';
+                three(row + 9, ms[i]);
+                three(row + 12, us[i]);
+                row[15] = ' ';
+            }
+        }
+
+#ifdef ECHO_BATCH_AVX2
+        /**
+         * @brief AVX2 clock kernel: 8 records per iteration, scalar tail
+         *
+         * Each field is divided with 32-bit multiply-shift, its digits are
+         * packed into four 32-bit words per record ("HH:M", "M:SS", ".mmm",
+         * "uuu "), and a 4x4 transpose turns the word vectors into 16-byte rows.
+         */
+        inline void render_clock_rows(const uint32_t *sod, const uint32_t *ms, const uint32_t *us, size_t count,
+                                      char *rows) {
+            const __m256i c10 = _mm256_set1_epi32(10);
+            const __m256i c60 = _mm256_set1_epi32(60);
+            const __m256i c100 = _mm256_set1_epi32(100);
+            const __m256i c3600 = _mm256_set1_epi32(3600);
+
+            auto div = [](__m256i v, int magic, int shift) {
+                return _mm256_srli_epi32(_mm256_mullo_epi32(v, _mm256_set1_epi32(magic)), shift);
+            };
+            // v < 100 -> tens | ones << 8
+            auto two = [&](__m256i v) {
+                __m256i tens = div(v, 103, 10);
+                __m256i ones = _mm256_sub_epi32(v, _mm256_mullo_epi32(tens, c10));
+                return _mm256_or_si256(tens, _mm256_slli_epi32(ones, 8));
+            };
+            // v < 1000 -> hundreds | tens << 8 | ones << 16
+            auto three = [&](__m256i v) {
+                __m256i hundreds = div(v, 41, 12);
+                __m256i rest = _mm256_sub_epi32(v, _mm256_mullo_epi32(hundreds, c100));
+                return _mm256_or_si256(hundreds, _mm256_slli_epi32(two(rest), 8));
+            };
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sod + i));
+                __m256i h = div(s, 37283, 27);
+                __m256i rem = _mm256_sub_epi32(s, _mm256_mullo_epi32(h, c3600));
+                __m256i m = div(rem, 34953, 21);
+                __m256i sec = _mm256_sub_epi32(rem, _mm256_mullo_epi32(m, c60));
+
+                __m256i hh = two(h);
+                __m256i mm = two(m);
+                __m256i ss = two(sec);
+
+                // Little-endian words; digits are < 10 so adding the ASCII base never carries
+                __m256i w0 = _mm256_add_epi32(_mm256_or_si256(hh, _mm256_slli_epi32(mm, 24)),
+                                              _mm256_set1_epi32(0x303A3030)); // "HH:M"
+                __m256i w1 = _mm256_add_epi32(_mm256_or_si256(_mm256_srli_epi32(mm, 8), _mm256_slli_epi32(ss, 16)),
+                                              _mm256_set1_epi32(0x30303A30)); // "M:SS"
+                __m256i w2 = _mm256_add_epi32(
+                    _mm256_slli_epi32(three(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(ms + i))), 8),
+                    _mm256_set1_epi32(0x3030302E)); // ".mmm"
+                __m256i w3 = _mm256_add_epi32(three(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(us + i))),
+                                              _mm256_set1_epi32(0x20303030)); // "uuu "
+
+                // Transpose: rows 0-3 in the low 128-bit halves, rows 4-7 in the high halves
+                __m256i a = _mm256_unpacklo_epi32(w0, w1);
+                __m256i b = _mm256_unpacklo_epi32(w2, w3);
+                __m256i c = _mm256_unpackhi_epi32(w0, w1);
+                __m256i d = _mm256_unpackhi_epi32(w2, w3);
+                __m256i r0 = _mm256_unpacklo_epi64(a, b);
+                __m256i r1 = _mm256_unpackhi_epi64(a, b);
+                __m256i r2 = _mm256_unpacklo_epi64(c, d);
+                __m256i r3 = _mm256_unpackhi_epi64(c, d);
+
+                auto *out = reinterpret_cast<__m256i *>(rows + i * CLOCK_ROW);
+                _mm256_storeu_si256(out + 0, _mm256_permute2x128_si256(r0, r1, 0x20));
+                _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(r2, r3, 0x20));
+                _mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(r0, r1, 0x31));
+                _mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(r2, r3, 0x31));
+            }
+            render_clock_rows_scalar(sod + i, ms + i, us + i, count - i, rows + i * CLOCK_ROW);
+        }
+#else
+        inline void render_clock_rows(const uint32_t *sod, const uint32_t *ms, const uint32_t *us, size_t count,
+                                      char *rows) {
+            render_clock_rows_scalar(sod, ms, us, count, rows);
+        }
+#endif
+
+    } // namespace detail
+
+    /**
+     * @brief Renders a RecordBatch into one contiguous buffer
+     *
+     * Level prefixes are built once per renderer and category prefixes once
+     * per add_category(). A renderer keeps scratch arrays between batches and
+     * is not thread-safe; use one per draining thread.
+     */
+    class BatchRenderer {
+      private:
+        BatchRendererOptions options_;
+        std::string level_prefix_[7]; // Indexed by Level, Off included
+        std::vector<std::string> category_names_;
+        std::vector<std::string> category_prefix_;
+
+        // Scratch, reused across batches
+        std::vector<uint32_t> sod_;
+        std::vector<uint32_t> ms_;
+        std::vector<uint32_t> us_;
+        std::vector<char> rows_;
+        int64_t offset_window_ = INT64_MIN; // 15-minute window the cached UTC offset was taken in
+        int64_t offset_ = 0;
+
+        size_t stamp_width() const {
+            switch (options_.precision) {
+            case TimestampPrecision::None:
+                return 0;
+            case TimestampPrecision::Seconds:
+                return 8;
+            case TimestampPrecision::Millis:
+                return 12;
+            case TimestampPrecision::Micros:
+                return 15;
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Offset from UTC, in seconds, of the first record's local time
+         *
+         * Taken once per batch; a batch spanning a DST change renders its
+         * tail with the earlier offset. Zones change offset on quarter-hour
+         * boundaries, so the value is cached for the 15-minute window.
+         */
+        int64_t utc_offset(int64_t seconds) {
+            if (options_.utc) {
+                return 0;
+            }
+            int64_t window = seconds / 900 - (seconds % 900 < 0 ? 1 : 0);
+            if (window == offset_window_) {
+                return offset_;
+            }
+            std::time_t t = static_cast<std::time_t>(seconds);
+            std::tm local = *std::localtime(&t);
+            int64_t local_sod = local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+            int64_t utc_sod = ((seconds % 86400) + 86400) % 86400;
+            int64_t offset = local_sod - utc_sod;
+            if (offset > 14 * 3600) {
+                offset -= 86400;
+            } else if (offset < -14 * 3600) {
+                offset += 86400;
+            }
+            offset_window_ = window;
+            offset_ = offset;
+            return offset;
+        }
+
+        /**
+         * @brief Pass 1 and 2: split timestamps, then convert them to text rows
+         */
+        void render_clock(const RecordBatch &batch) {
+            const size_t n = batch.size();
+            sod_.resize(n);
+            ms_.resize(n);
+            us_.resize(n);
+            rows_.resize(n * detail::CLOCK_ROW);
+
+            const int64_t offset_ns = utc_offset(batch.timestamps[0] / 1000000000) * 1000000000;
+            for (size_t i = 0; i < n; ++i) {
+                int64_t t = batch.timestamps[i] + offset_ns;
+                int64_t seconds = t / 1000000000;
+                int64_t frac = t - seconds * 1000000000;
+                if (frac < 0) {
+                    frac += 1000000000;
+                    --seconds;
+                }
+                int64_t day_seconds = seconds % 86400;
+                sod_[i] = static_cast<uint32_t>(day_seconds < 0 ? day_seconds + 86400 : day_seconds);
+                ms_[i] = static_cast<uint32_t>(frac / 1000000);
+                us_[i] = static_cast<uint32_t>((frac / 1000) % 1000);
+            }
+            detail::render_clock_rows(sod_.data(), ms_.data(), us_.data(), n, rows_.data());
+        }
+
+        /// Levels outside Trace..Off (RecordBatch::levels is writable) use the Off slot: "[unknown]", as level_name()
+        [[nodiscard]] const std::string &level_prefix(Level level) const {
+            auto i = static_cast<unsigned>(level);
+            return level_prefix_[i <= static_cast<unsigned>(Level::Off) ? i : static_cast<unsigned>(Level::Off)];
+        }
+
+      public:
+        explicit BatchRenderer(BatchRendererOptions options = {}) : options_(options) {
+            for (int i = 0; i < 7; ++i) {
+                Level level = static_cast<Level>(i);
+                std::string &prefix = level_prefix_[i];
+                if (options_.color) {
+                    prefix += detail::level_color(level);
+                }
+                prefix += '[';
+                prefix += detail::level_name(level);
+                prefix += ']';
+                if (options_.color) {
+                    prefix += detail::RESET;
+                }
+                prefix += ' ';
+            }
+        }
+
+        /**
+         * @brief Register a category and get its ID (the same name always gets the same ID)
+         */
+        uint16_t add_category(std::string_view name) {
+            for (size_t i = 0; i < category_names_.size(); ++i) {
+                if (category_names_[i] == name) {
+                    return static_cast<uint16_t>(i);
+                }
+            }
+            category_names_.emplace_back(name);
+            category_prefix_.push_back('[' + std::string(name) + "] ");
+            return static_cast<uint16_t>(category_names_.size() - 1);
+        }
+
+        /**
+         * @brief Name of a registered category ("" for unknown IDs)
+         */
+        [[nodiscard]] std::string_view category_name(uint16_t id) const {
+            return id < category_names_.size() ? std::string_view(category_names_[id]) : std::string_view();
+        }
+
+        /**
+         * @brief Append a rendered batch to a block, one line per record
+         * @return Bytes appended
+         */
+        size_t render(const RecordBatch &batch, LogBlock &out) {
+            const size_t n = batch.size();
+            if (n == 0) {
+                return 0;
+            }
+            const size_t width = stamp_width();
+            if (width > 0) {
+                render_clock(batch);
+            }
+
+            // Pass 3: size everything once, then copy with no further reallocation
+            const size_t stamp_bytes = width > 0 ? width + 2 : 0;
+            size_t total = batch.messages.size() + n * (stamp_bytes + 1);
+            for (size_t i = 0; i < n; ++i) {
+                total += level_prefix(batch.levels[i]).size();
+                uint16_t cat = batch.categories[i];
+                if (cat < category_prefix_.size()) {
+                    total += category_prefix_[cat].size();
+                }
+            }
+
+            const size_t start = out.text.size();
+            out.text.resize(start + total);
+            out.lines.reserve(out.lines.size() + n);
+            char *p = out.text.data() + start;
+            const char *body = batch.messages.data();
+            uint32_t begin = 0;
+
+            for (size_t i = 0; i < n; ++i) {
+                const size_t line_begin = static_cast<size_t>(p - out.text.data());
+                if (width > 0) {
+                    *p++ = '[';
+                    std::memcpy(p, rows_.data() + i * detail::CLOCK_ROW, width);
+                    p += width;
+                    *p++ = ']';
+                }
+                const std::string &level = level_prefix(batch.levels[i]);
+                std::memcpy(p, level.data(), level.size());
+                p += level.size();
+                uint16_t cat = batch.categories[i];
+                if (cat < category_prefix_.size()) {
+                    std::memcpy(p, category_prefix_[cat].data(), category_prefix_[cat].size());
+                    p += category_prefix_[cat].size();
+                }
+                uint32_t end = batch.ends[i];
+                std::memcpy(p, body + begin, end - begin);
+                p += end - begin;
+                begin = end;
+                *p++ = '\n';
+                out.lines.push_back({batch.levels[i], line_begin, static_cast<size_t>(p - out.text.data())});
+            }
+            return total;
+        }
+
+        /**
+         * @brief Append a rendered batch to a string
+         */
+        void render(const RecordBatch &batch, std::string &out) {
+            LogBlock block;
+            block.text.swap(out);
+            render(batch, block);
+            block.text.swap(out);
+        }
+
+        [[nodiscard]] const BatchRendererOptions &options() const noexcept { return options_; }
+    };
+
+} // namespace echo
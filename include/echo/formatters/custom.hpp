@@ -15,6 +15,9 @@ namespace echo {
      * @brief Custom formatter using a user-provided function
      *
      * Allows users to provide their own formatting logic via a lambda or function.
+     * Two function shapes are accepted:
+     * - FormatFunc returns a string (simple, allocates per record)
+     * - AppendFunc appends into the output buffer (allocation-free with a reused buffer)
      *
      * Example:
      *   auto formatter = std::make_shared<CustomFormatter>(
@@ -22,14 +25,27 @@ namespace echo {
      *           return "[" + rec.timestamp + "] " + rec.message;
      *       }
      *   );
+     *
+     *   auto appender = std::make_shared<CustomFormatter>(
+     *       [](std::string& out, const LogRecordView& rec) {
+     *           out += '[';
+     *           out += rec.timestamp;
+     *           out += "] ";
+     *           out += rec.message;
+     *       }
+     *   );
      */
     class CustomFormatter : public Formatter {
       public:
         /// Function type for custom formatting
         using FormatFunc = std::function<std::string(const LogRecord &)>;
 
+        /// Function type for append-style custom formatting
+        using AppendFunc = std::function<void(std::string &, const LogRecordView &)>;
+
       private:
         FormatFunc format_func_;
+        AppendFunc append_func_;
 
       public:
         /**
@@ -38,15 +54,44 @@ namespace echo {
          */
         explicit CustomFormatter(FormatFunc func) : format_func_(std::move(func)) {}
 
+        /**
+         * @brief Construct append-style custom formatter
+         * @param func Function appending the formatted record to a buffer
+         */
+        explicit CustomFormatter(AppendFunc func) : append_func_(std::move(func)) {}
+
+        void format_to(std::string &out, const LogRecordView &record) override {
+            const size_t start = out.size();
+            if (append_func_) {
+                append_func_(out, record);
+            } else if (format_func_) {
+                out += format_func_(record.to_record());
+            } else {
+                // Fallback to simple format if no function provided
+                out += record.message;
+            }
+
+            // User code cannot be stopped early: cut its output afterwards
+            if (detail::exceeds_record_size(std::string_view(out).substr(start), max_record_size_)) {
+                std::string capped;
+                detail::truncate_record(std::string_view(out).substr(start), max_record_size_, capped);
+                out.replace(start, std::string::npos, capped);
+            }
+        }
+
         std::string format(const LogRecord &record) override {
-            if (format_func_) {
+            if (format_func_ && max_record_size_ == 0) {
                 return format_func_(record);
             }
-            // Fallback to simple format if no function provided
-            return record.message;
+            return Formatter::format(record);
         }
 
-        std::unique_ptr<Formatter> clone() const override { return std::make_unique<CustomFormatter>(format_func_); }
+        std::unique_ptr<Formatter> clone() const override {
+            auto copy = append_func_ ? std::make_unique<CustomFormatter>(append_func_)
+                                     : std::make_unique<CustomFormatter>(format_func_);
+            copy->set_max_record_size(max_record_size_);
+            return copy;
+        }
     };
 
 } // namespace echo
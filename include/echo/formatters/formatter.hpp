@@ -6,9 +6,12 @@
  */
 
 #include <echo/core/level.hpp>
+#include <echo/core/record_size.hpp>
 
+#include <charconv>
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace echo {
 
@@ -27,28 +30,169 @@ namespace echo {
         bool has_color = false;      ///< Whether message has color
     };
 
+    /**
+     * @brief Non-owning view of a log event
+     *
+     * Same fields as LogRecord, but nothing is copied: the message, timestamp and
+     * color code point into buffers owned by the caller, and file/function point to
+     * static call-site data (__FILE__, __func__). Building one costs no allocations.
+     *
+     * The view is only valid while the referenced data is alive.
+     */
+    struct LogRecordView {
+        Level level = Level::Info;      ///< Log level
+        std::string_view message;       ///< Formatted message
+        std::string_view timestamp;     ///< Timestamp string
+        const char *file = nullptr;     ///< Source file (static, optional)
+        int line = 0;                   ///< Source line (optional)
+        const char *function = nullptr; ///< Function name (static, optional)
+        unsigned long thread_id = 0;    ///< Thread ID (optional)
+        std::string_view color_code;    ///< ANSI color code (if any)
+        bool has_color = false;         ///< Whether message has color
+
+        LogRecordView() = default;
+
+        /**
+         * @brief View an owning LogRecord
+         * @param record Record to view (must outlive the view)
+         */
+        LogRecordView(const LogRecord &record)
+            : level(record.level), message(record.message), timestamp(record.timestamp),
+              file(record.file.empty() ? nullptr : record.file.c_str()), line(record.line),
+              function(record.function.empty() ? nullptr : record.function.c_str()), thread_id(record.thread_id),
+              color_code(record.color_code), has_color(record.has_color) {}
+
+        /**
+         * @brief Materialize an owning copy of this view
+         * @return LogRecord with all fields copied
+         */
+        [[nodiscard]] LogRecord to_record() const {
+            LogRecord record;
+            record.level = level;
+            record.message.assign(message);
+            record.timestamp.assign(timestamp);
+            if (file) {
+                record.file = file;
+            }
+            record.line = line;
+            if (function) {
+                record.function = function;
+            }
+            record.thread_id = thread_id;
+            record.color_code.assign(color_code);
+            record.has_color = has_color;
+            return record;
+        }
+    };
+
+    namespace detail {
+        /**
+         * @brief Append an unsigned integer to a buffer without temporaries
+         */
+        inline void append_uint(std::string &out, unsigned long value) {
+            char digits[24];
+            auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, static_cast<size_t>(end - digits));
+        }
+    } // namespace detail
+
     /**
      * @brief Abstract base class for log formatters
      *
      * Formatters convert LogRecord objects into formatted strings.
      * Each sink can have its own formatter.
+     *
+     * There are two entry points:
+     * - format_to(): appends to a caller-owned buffer. Reusing the same buffer
+     *   (clear() keeps its capacity) makes formatting allocation-free once the
+     *   buffer has grown to the working size. This is the primary interface.
+     * - format(): returns a fresh string. Kept for compatibility; by default it
+     *   is an adapter over format_to().
+     *
+     * Subclasses must implement format_to(). Formatters written against the old
+     * string-returning interface derive from StringFormatterAdapter instead.
      */
     class Formatter {
       public:
         virtual ~Formatter() = default;
 
+        /**
+         * @brief Append a formatted log record to a buffer
+         * @param out Buffer to append to (existing contents are kept)
+         * @param record Log record to format
+         */
+        virtual void format_to(std::string &out, const LogRecordView &record) = 0;
+
         /**
          * @brief Format a log record into a string
          * @param record Log record to format
          * @return Formatted string
          */
-        virtual std::string format(const LogRecord &record) = 0;
+        virtual std::string format(const LogRecord &record) {
+            std::string result;
+            format_to(result, LogRecordView(record));
+            return result;
+        }
 
         /**
          * @brief Clone this formatter
          * @return Unique pointer to a copy of this formatter
          */
         virtual std::unique_ptr<Formatter> clone() const = 0;
+
+        /**
+         * @brief Cap the size of each formatted record
+         * @param bytes Maximum record bytes before the truncation marker (0 = unlimited)
+         *
+         * The message is cut while it is appended, so a huge message costs
+         * O(bytes). Fields after the message in a pattern are still written.
+         */
+        void set_max_record_size(size_t bytes) noexcept { max_record_size_ = bytes; }
+
+        /**
+         * @brief Get the record size cap (0 = unlimited)
+         */
+        [[nodiscard]] size_t max_record_size() const noexcept { return max_record_size_; }
+
+      protected:
+        /**
+         * @brief Append the message (with its color) within what is left of the record cap
+         * @param out Buffer being formatted into
+         * @param record Record being formatted
+         * @param record_start Size of out when formatting of this record began
+         */
+        void append_message(std::string &out, const LogRecordView &record, size_t record_start) const {
+            const bool colored = record.has_color && !record.color_code.empty();
+            const size_t used = out.size() - record_start;
+            if (colored) {
+                out += record.color_code;
+            }
+            if (max_record_size_ == 0) {
+                out += record.message;
+            } else {
+                detail::BoundedAppender message(out, used < max_record_size_ ? max_record_size_ - used : 0);
+                message.append(record.message);
+                message.finish();
+            }
+            if (colored) {
+                out += detail::RESET;
+            }
+        }
+
+        size_t max_record_size_ = 0; ///< Record size cap in bytes (0 = unlimited)
+    };
+
+    /**
+     * @brief Base for formatters written against the string-returning interface
+     *
+     * Subclasses implement format(); format_to() adapts it by copying the view
+     * into a LogRecord, so these formatters allocate on every record.
+     */
+    class StringFormatterAdapter : public Formatter {
+      public:
+        std::string format(const LogRecord &record) override = 0;
+
+        void format_to(std::string &out, const LogRecordView &record) override { out += format(record.to_record()); }
     };
 
     /// Shared pointer to a formatter
@@ -73,32 +217,32 @@ namespace echo {
         explicit DefaultFormatter(bool include_timestamp = true, bool include_level = true)
             : include_timestamp_(include_timestamp), include_level_(include_level) {}
 
-        std::string format(const LogRecord &record) override {
-            std::string result;
+        void format_to(std::string &out, const LogRecordView &record) override {
+            const size_t start = out.size();
 
             if (include_timestamp_ && !record.timestamp.empty()) {
-                result += "[" + record.timestamp + "]";
+                out += '[';
+                out += record.timestamp;
+                out += ']';
             }
 
             if (include_level_) {
-                result += "[" + std::string(detail::level_name(record.level)) + "]";
-            }
-
-            if (!result.empty()) {
-                result += " ";
+                out += '[';
+                out += detail::level_name(record.level);
+                out += ']';
             }
 
-            if (record.has_color && !record.color_code.empty()) {
-                result += record.color_code + record.message + detail::RESET;
-            } else {
-                result += record.message;
+            if (out.size() != start) {
+                out += ' ';
             }
 
-            return result;
+            append_message(out, record, start);
         }
 
         std::unique_ptr<Formatter> clone() const override {
-            return std::make_unique<DefaultFormatter>(include_timestamp_, include_level_);
+            auto copy = std::make_unique<DefaultFormatter>(include_timestamp_, include_level_);
+            copy->set_max_record_size(max_record_size_);
+            return copy;
         }
     };
 
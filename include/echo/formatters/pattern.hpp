@@ -18,9 +18,9 @@
 
 #include <echo/formatters/formatter.hpp>
 
-#include <regex>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace echo {
 
@@ -29,6 +29,10 @@ namespace echo {
      *
      * Formats log records using a pattern string with placeholders.
      *
+     * The pattern is compiled once into a list of literal and field segments, so
+     * formatting a record is a single pass of appends into the output buffer.
+     * Unknown placeholders are kept verbatim.
+     *
      * Example patterns:
      * - "[{time}][{level}] {msg}"
      * - "{level:5} | {msg}"
@@ -36,27 +40,88 @@ namespace echo {
      */
     class PatternFormatter : public Formatter {
       private:
+        /**
+         * @brief Kind of a compiled pattern segment
+         */
+        enum class Field { Literal, Timestamp, Level, Message, File, Line, Function, Thread };
+
+        /**
+         * @brief One compiled pattern segment
+         *
+         * For literals, [offset, offset + length) indexes into pattern_.
+         */
+        struct Segment {
+            Field field;
+            size_t offset = 0;
+            size_t length = 0;
+        };
+
         std::string pattern_;
+        std::vector<Segment> segments_;
+
+        /**
+         * @brief Map a placeholder name to its field
+         * @param name Placeholder name (without braces)
+         * @return Field, or Field::Literal if the name is unknown
+         */
+        static Field lookup_field(std::string_view name) {
+            if (name == "timestamp" || name == "time")
+                return Field::Timestamp;
+            if (name == "level")
+                return Field::Level;
+            if (name == "message" || name == "msg")
+                return Field::Message;
+            if (name == "file")
+                return Field::File;
+            if (name == "line")
+                return Field::Line;
+            if (name == "function" || name == "func")
+                return Field::Function;
+            if (name == "thread")
+                return Field::Thread;
+            return Field::Literal;
+        }
 
         /**
-         * @brief Replace a placeholder in the pattern
-         * @param pattern Pattern string
-         * @param placeholder Placeholder name (without braces)
-         * @param value Replacement value
-         * @return Pattern with placeholder replaced
+         * @brief Split pattern_ into literal and field segments
          */
-        static std::string replace_placeholder(const std::string &pattern, const std::string &placeholder,
-                                               const std::string &value) {
-            std::string result = pattern;
-            std::string full_placeholder = "{" + placeholder + "}";
+        void compile() {
+            segments_.clear();
+            size_t literal_start = 0;
             size_t pos = 0;
 
-            while ((pos = result.find(full_placeholder, pos)) != std::string::npos) {
-                result.replace(pos, full_placeholder.length(), value);
-                pos += value.length();
+            auto flush_literal = [&](size_t end) {
+                if (end > literal_start) {
+                    // Merge with a preceding literal (e.g. after an unknown placeholder)
+                    if (!segments_.empty() && segments_.back().field == Field::Literal &&
+                        segments_.back().offset + segments_.back().length == literal_start) {
+                        segments_.back().length += end - literal_start;
+                    } else {
+                        segments_.push_back({Field::Literal, literal_start, end - literal_start});
+                    }
+                }
+            };
+
+            while ((pos = pattern_.find('{', pos)) != std::string::npos) {
+                size_t close = pattern_.find('}', pos + 1);
+                if (close == std::string::npos) {
+                    break;
+                }
+
+                Field field = lookup_field(std::string_view(pattern_).substr(pos + 1, close - pos - 1));
+                if (field == Field::Literal) {
+                    // Not a placeholder we know; keep the '{' as text and rescan after it
+                    ++pos;
+                    continue;
+                }
+
+                flush_literal(pos);
+                segments_.push_back({field, 0, 0});
+                pos = close + 1;
+                literal_start = pos;
             }
 
-            return result;
+            flush_literal(pattern_.size());
         }
 
       public:
@@ -66,66 +131,55 @@ namespace echo {
          *
          * Default pattern: "[{time}][{level}] {msg}"
          */
-        explicit PatternFormatter(const std::string &pattern = "[{time}][{level}] {msg}") : pattern_(pattern) {}
-
-        std::string format(const LogRecord &record) override {
-            std::string result = pattern_;
-
-            // Replace timestamp placeholders
-            if (!record.timestamp.empty()) {
-                result = replace_placeholder(result, "timestamp", record.timestamp);
-                result = replace_placeholder(result, "time", record.timestamp);
-            } else {
-                result = replace_placeholder(result, "timestamp", "");
-                result = replace_placeholder(result, "time", "");
-            }
-
-            // Replace level placeholder
-            std::string level_name = detail::level_name(record.level);
-            result = replace_placeholder(result, "level", level_name);
-
-            // Replace message placeholder
-            std::string message = record.message;
-            if (record.has_color && !record.color_code.empty()) {
-                message = record.color_code + message + detail::RESET;
-            }
-            result = replace_placeholder(result, "message", message);
-            result = replace_placeholder(result, "msg", message);
-
-            // Replace file placeholder
-            if (!record.file.empty()) {
-                result = replace_placeholder(result, "file", record.file);
-            } else {
-                result = replace_placeholder(result, "file", "");
-            }
-
-            // Replace line placeholder
-            if (record.line > 0) {
-                result = replace_placeholder(result, "line", std::to_string(record.line));
-            } else {
-                result = replace_placeholder(result, "line", "");
-            }
-
-            // Replace function placeholder
-            if (!record.function.empty()) {
-                result = replace_placeholder(result, "function", record.function);
-                result = replace_placeholder(result, "func", record.function);
-            } else {
-                result = replace_placeholder(result, "function", "");
-                result = replace_placeholder(result, "func", "");
-            }
+        explicit PatternFormatter(const std::string &pattern = "[{time}][{level}] {msg}") : pattern_(pattern) {
+            compile();
+        }
 
-            // Replace thread placeholder
-            if (record.thread_id > 0) {
-                result = replace_placeholder(result, "thread", std::to_string(record.thread_id));
-            } else {
-                result = replace_placeholder(result, "thread", "");
+        void format_to(std::string &out, const LogRecordView &record) override {
+            const size_t start = out.size();
+            for (const auto &segment : segments_) {
+                switch (segment.field) {
+                case Field::Literal:
+                    out.append(pattern_, segment.offset, segment.length);
+                    break;
+                case Field::Timestamp:
+                    out += record.timestamp;
+                    break;
+                case Field::Level:
+                    out += detail::level_name(record.level);
+                    break;
+                case Field::Message:
+                    append_message(out, record, start);
+                    break;
+                case Field::File:
+                    if (record.file) {
+                        out += record.file;
+                    }
+                    break;
+                case Field::Line:
+                    if (record.line > 0) {
+                        detail::append_uint(out, static_cast<unsigned long>(record.line));
+                    }
+                    break;
+                case Field::Function:
+                    if (record.function) {
+                        out += record.function;
+                    }
+                    break;
+                case Field::Thread:
+                    if (record.thread_id > 0) {
+                        detail::append_uint(out, record.thread_id);
+                    }
+                    break;
+                }
             }
-
-            return result;
         }
 
-        std::unique_ptr<Formatter> clone() const override { return std::make_unique<PatternFormatter>(pattern_); }
+        std::unique_ptr<Formatter> clone() const override {
+            auto copy = std::make_unique<PatternFormatter>(pattern_);
+            copy->set_max_record_size(max_record_size_);
+            return copy;
+        }
 
         /**
          * @brief Get the current pattern
@@ -137,7 +191,10 @@ namespace echo {
          * @brief Set a new pattern
          * @param pattern New pattern string
          */
-        void set_pattern(const std::string &pattern) { pattern_ = pattern; }
+        void set_pattern(const std::string &pattern) {
+            pattern_ = pattern;
+            compile();
+        }
     };
 
 } // namespace echo
@@ -0,0 +1,405 @@
+#pragma once
+
+/**
+ * @file freestanding.hpp
+ * @brief Low-footprint logging profile for constrained targets
+ *
+ * Enabled with -DECHO_FREESTANDING, in which case echo/echo.hpp includes only
+ * this header: sinks, formatters, filters, widgets and format.hpp are compiled
+ * out. Compared to the full profile:
+ * - no <iostream>, <sstream>, <regex> or std::format; numbers are converted by hand
+ * - no exceptions; every call returns a Status and updates counters
+ * - no heap: one statically allocated line buffer of ECHO_LINE_BUFFER_SIZE bytes
+ * - output goes to a user write callback (UART, RTT, semihosting, ring buffer...)
+ * - no environment lookup, colors, timestamps, or .once()/.every() tables
+ *
+ * Lines have the form "[level] message\n". Longer messages are truncated to
+ * fit the buffer (the newline is always kept). Works with -fno-exceptions,
+ * -fno-rtti and -fno-threadsafe-statics.
+ *
+ * The line buffer is shared. On targets with threads or interrupts that log,
+ * install lock callbacks (e.g. a mutex, or masking interrupts).
+ *
+ * Tunables (define before including):
+ *   ECHO_LINE_BUFFER_SIZE  - bytes per line including newline (default 256)
+ *   ECHO_FLOAT_PRECISION   - digits after the decimal point (default 3)
+ *
+ * Example:
+ *   #define ECHO_FREESTANDING
+ *   #include <echo/echo.hpp>
+ *
+ *   void uart_write(echo::Level, const char *data, size_t size, void *) { uart_send(data, size); }
+ *
+ *   int main() {
+ *       echo::set_write_callback(uart_write);
+ *       echo::info("boot ok, vcc=", read_vcc(), "V");
+ *       if (echo::warn("temp ", t) == echo::Status::Truncated) { ... }
+ *   }
+ */
+
+#include <echo/core/level.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+// <atomic> is a freestanding header, but not every target has lock-free 32-bit atomics
+#if __has_include(<atomic>)
+#include <atomic>
+#if ATOMIC_INT_LOCK_FREE == 2
+#define ECHO_FREESTANDING_ATOMIC_FILTERED 1
+#endif
+#endif
+
+#ifndef ECHO_LINE_BUFFER_SIZE
+#define ECHO_LINE_BUFFER_SIZE 256
+#endif
+
+#ifndef ECHO_FLOAT_PRECISION
+#define ECHO_FLOAT_PRECISION 3
+#endif
+
+static_assert(ECHO_LINE_BUFFER_SIZE >= 16, "ECHO_LINE_BUFFER_SIZE too small");
+static_assert(ECHO_FLOAT_PRECISION >= 0 && ECHO_FLOAT_PRECISION <= 9, "ECHO_FLOAT_PRECISION must be 0-9");
+
+namespace echo {
+
+    /// Receives each finished line (not NUL-terminated)
+    using WriteCallback = void (*)(Level level, const char *data, size_t size, void *user);
+
+    /// Lock/unlock hook protecting the shared line buffer
+    using LockCallback = void (*)(void *user);
+
+    /**
+     * @brief Result of a log call
+     */
+    enum class Status : uint8_t {
+        Ok,        ///< Line written
+        Filtered,  ///< Below the compile-time or runtime level
+        Truncated, ///< Line written, but cut to ECHO_LINE_BUFFER_SIZE
+        NoWriter   ///< No write callback installed; line dropped
+    };
+
+    /**
+     * @brief Counters since start or reset_stats()
+     *
+     * Where 32-bit atomics are lock-free, `filtered` is a relaxed atomic and
+     * filtered calls never reach the lock callbacks. Elsewhere it is counted
+     * under the lock.
+     */
+    struct FreestandingStats {
+        uint32_t written = 0;   ///< Lines passed to the write callback
+        uint32_t filtered = 0;  ///< Lines below the runtime level
+        uint32_t truncated = 0; ///< Written lines that did not fit
+        uint32_t dropped = 0;   ///< Lines lost for lack of a write callback
+    };
+
+    namespace detail {
+
+        // =================================================================================================
+        // Static state
+        // =================================================================================================
+
+        struct FreestandingState {
+            WriteCallback write = nullptr;
+            void *write_user = nullptr;
+            LockCallback lock = nullptr;
+            LockCallback unlock = nullptr;
+            void *lock_user = nullptr;
+            FreestandingStats stats{};
+#ifdef ECHO_FREESTANDING_ATOMIC_FILTERED
+            std::atomic<uint32_t> filtered{0}; ///< Reported as stats.filtered
+#endif
+            char buffer[ECHO_LINE_BUFFER_SIZE] = {};
+        };
+
+        /// Constant-initialized: lives in .bss, no constructor or guard runs
+        inline constinit FreestandingState freestanding_state{};
+
+        // =================================================================================================
+        // Bounded line writer
+        // =================================================================================================
+
+        /**
+         * @brief Appends into a fixed buffer, silently cutting what does not fit
+         */
+        class LineWriter {
+          private:
+            char *data_;
+            size_t capacity_;
+            size_t size_ = 0;
+            bool truncated_ = false;
+
+          public:
+            LineWriter(char *data, size_t capacity) noexcept : data_(data), capacity_(capacity) {}
+
+            void put(const char *s, size_t n) noexcept {
+                size_t room = capacity_ - size_;
+                if (n > room) {
+                    n = room;
+                    truncated_ = true;
+                }
+                std::memcpy(data_ + size_, s, n);
+                size_ += n;
+            }
+
+            void put(char c) noexcept {
+                if (size_ < capacity_) {
+                    data_[size_++] = c;
+                } else {
+                    truncated_ = true;
+                }
+            }
+
+            [[nodiscard]] size_t size() const noexcept { return size_; }
+            [[nodiscard]] bool truncated() const noexcept { return truncated_; }
+        };
+
+        // =================================================================================================
+        // Conversions (no locale, no allocation)
+        // =================================================================================================
+
+        inline void append_unsigned(LineWriter &w, uint64_t v) noexcept {
+            char digits[20];
+            size_t n = 0;
+            do {
+                digits[n++] = static_cast<char>('0' + v % 10);
+                v /= 10;
+            } while (v != 0);
+            while (n > 0) {
+                w.put(digits[--n]);
+            }
+        }
+
+        inline void append(LineWriter &w, std::string_view s) noexcept { w.put(s.data(), s.size()); }
+
+        inline void append(LineWriter &w, const char *s) noexcept {
+            if (s) {
+                w.put(s, std::strlen(s));
+            } else {
+                w.put("(null)", 6);
+            }
+        }
+
+        inline void append(LineWriter &w, char c) noexcept { w.put(c); }
+
+        inline void append(LineWriter &w, bool b) noexcept { b ? w.put("true", 4) : w.put("false", 5); }
+
+        inline void append(LineWriter &w, std::nullptr_t) noexcept { w.put("nullptr", 7); }
+
+        template <typename T>
+            requires(std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>)
+        inline void append(LineWriter &w, T v) noexcept {
+            if constexpr (std::is_signed_v<T>) {
+                if (v < 0) {
+                    w.put('-');
+                    // Negate in unsigned arithmetic so the minimum value does not overflow
+                    append_unsigned(w, 0 - static_cast<uint64_t>(v));
+                    return;
+                }
+            }
+            append_unsigned(w, static_cast<uint64_t>(v));
+        }
+
+        template <typename T>
+            requires std::is_floating_point_v<T>
+        inline void append(LineWriter &w, T value) noexcept {
+            double v = static_cast<double>(value);
+            if (v != v) {
+                w.put("nan", 3);
+                return;
+            }
+            if (v < 0) {
+                w.put('-');
+                v = -v;
+            }
+            if (v > 1.8e19) {
+                // Beyond uint64_t: print as mantissa and exponent
+                int exponent = 0;
+                while (v >= 10.0 && exponent < 400) {
+                    v /= 10.0;
+                    ++exponent;
+                }
+                if (exponent >= 400) {
+                    w.put("inf", 3);
+                    return;
+                }
+                append(w, v);
+                w.put("e+", 2);
+                append_unsigned(w, static_cast<uint64_t>(exponent));
+                return;
+            }
+
+            constexpr uint64_t scale = [] {
+                uint64_t s = 1;
+                for (int i = 0; i < ECHO_FLOAT_PRECISION; ++i) {
+                    s *= 10;
+                }
+                return s;
+            }();
+            uint64_t integral = static_cast<uint64_t>(v);
+            uint64_t fraction = static_cast<uint64_t>((v - static_cast<double>(integral)) * scale + 0.5);
+            if (fraction >= scale) {
+                ++integral;
+                fraction -= scale;
+            }
+            append_unsigned(w, integral);
+            if constexpr (ECHO_FLOAT_PRECISION > 0) {
+                w.put('.');
+                char digits[ECHO_FLOAT_PRECISION > 0 ? ECHO_FLOAT_PRECISION : 1];
+                for (int i = ECHO_FLOAT_PRECISION - 1; i >= 0; --i) {
+                    digits[i] = static_cast<char>('0' + fraction % 10);
+                    fraction /= 10;
+                }
+                w.put(digits, ECHO_FLOAT_PRECISION);
+            }
+        }
+
+        inline void append(LineWriter &w, const void *p) noexcept {
+            static constexpr char hex[] = "0123456789abcdef";
+            uintptr_t v = reinterpret_cast<uintptr_t>(p);
+            char digits[sizeof(uintptr_t) * 2];
+            size_t n = 0;
+            do {
+                digits[n++] = hex[v & 0xf];
+                v >>= 4;
+            } while (v != 0);
+            w.put("0x", 2);
+            while (n > 0) {
+                w.put(digits[--n]);
+            }
+        }
+
+        /**
+         * @brief Holds the lock callbacks for the duration of a log call
+         */
+        class FreestandingLock {
+          public:
+            FreestandingLock() noexcept {
+                if (freestanding_state.lock) {
+                    freestanding_state.lock(freestanding_state.lock_user);
+                }
+            }
+            ~FreestandingLock() {
+                if (freestanding_state.unlock) {
+                    freestanding_state.unlock(freestanding_state.lock_user);
+                }
+            }
+            FreestandingLock(const FreestandingLock &) = delete;
+            FreestandingLock &operator=(const FreestandingLock &) = delete;
+        };
+
+    } // namespace detail
+
+    // =================================================================================================
+    // Configuration
+    // =================================================================================================
+
+    /**
+     * @brief Install the function that receives every line (nullptr to disable output)
+     */
+    inline void set_write_callback(WriteCallback callback, void *user = nullptr) noexcept {
+        detail::FreestandingLock lock;
+        detail::freestanding_state.write = callback;
+        detail::freestanding_state.write_user = user;
+    }
+
+    /**
+     * @brief Install lock/unlock hooks around each log call (both nullptr to disable)
+     */
+    inline void set_lock_callbacks(LockCallback lock, LockCallback unlock, void *user = nullptr) noexcept {
+        detail::freestanding_state.lock = lock;
+        detail::freestanding_state.unlock = unlock;
+        detail::freestanding_state.lock_user = user;
+    }
+
+    /**
+     * @brief Get counters
+     */
+    [[nodiscard]] inline FreestandingStats stats() noexcept {
+        detail::FreestandingLock lock;
+        FreestandingStats result = detail::freestanding_state.stats;
+#ifdef ECHO_FREESTANDING_ATOMIC_FILTERED
+        result.filtered = detail::freestanding_state.filtered.load(std::memory_order_relaxed);
+#endif
+        return result;
+    }
+
+    /**
+     * @brief Reset counters
+     */
+    inline void reset_stats() noexcept {
+        detail::FreestandingLock lock;
+        detail::freestanding_state.stats = {};
+#ifdef ECHO_FREESTANDING_ATOMIC_FILTERED
+        detail::freestanding_state.filtered.store(0, std::memory_order_relaxed);
+#endif
+    }
+
+    // =================================================================================================
+    // Logging
+    // =================================================================================================
+
+    /**
+     * @brief Format and write one line at level L
+     */
+    template <Level L, typename... Args> inline Status log(const Args &...args) noexcept {
+        if constexpr (static_cast<int>(L) < static_cast<int>(detail::ACTIVE_LEVEL)) {
+            ((void)args, ...);
+            return Status::Filtered;
+        } else {
+            auto &state = detail::freestanding_state;
+
+            // With atomics, filtered calls never reach the lock callbacks (e.g. masking interrupts)
+            if (static_cast<int>(L) < static_cast<int>(detail::get_effective_level())) {
+#ifdef ECHO_FREESTANDING_ATOMIC_FILTERED
+                state.filtered.fetch_add(1, std::memory_order_relaxed);
+#else
+                detail::FreestandingLock lock;
+                ++state.stats.filtered;
+#endif
+                return Status::Filtered;
+            }
+
+            detail::FreestandingLock lock;
+            if (!state.write) {
+                ++state.stats.dropped;
+                return Status::NoWriter;
+            }
+
+            // One byte is held back so the newline always fits
+            detail::LineWriter w(state.buffer, sizeof(state.buffer) - 1);
+            w.put('[');
+            detail::append(w, detail::level_name(L));
+            w.put("] ", 2);
+            (detail::append(w, args), ...);
+            state.buffer[w.size()] = '\n';
+
+            state.write(L, state.buffer, w.size() + 1, state.write_user);
+            ++state.stats.written;
+            if (w.truncated()) {
+                ++state.stats.truncated;
+                return Status::Truncated;
+            }
+            return Status::Ok;
+        }
+    }
+
+    template <typename... Args> inline Status trace(const Args &...args) noexcept {
+        return log<Level::Trace>(args...);
+    }
+    template <typename... Args> inline Status debug(const Args &...args) noexcept {
+        return log<Level::Debug>(args...);
+    }
+    template <typename... Args> inline Status info(const Args &...args) noexcept { return log<Level::Info>(args...); }
+    template <typename... Args> inline Status warn(const Args &...args) noexcept { return log<Level::Warn>(args...); }
+    template <typename... Args> inline Status error(const Args &...args) noexcept {
+        return log<Level::Error>(args...);
+    }
+    template <typename... Args> inline Status critical(const Args &...args) noexcept {
+        return log<Level::Critical>(args...);
+    }
+
+} // namespace echo
@@ -7,6 +7,7 @@
  * This sink is ALWAYS available and is the default output destination.
  */
 
+#include <echo/core/console.hpp>
 #include <echo/sinks/sink.hpp>
 
 #include <iostream>
@@ -20,7 +21,8 @@ namespace echo {
      * - Trace, Debug, Info, Warn → stdout
      * - Error, Critical → stderr
      *
-     * ANSI color codes are preserved (not stripped).
+     * ANSI color codes are preserved (not stripped). While StdioCapture is
+     * active, output goes to the original terminal rather than the capture pipes.
      *
      * Example:
      *   auto console = std::make_shared<ConsoleSink>();
@@ -43,16 +45,55 @@ namespace echo {
             }
 
             // Error and Critical go to stderr, everything else to stdout
-            std::ostream &out = (level >= Level::Error) ? std::cerr : std::cout;
+            std::ostream &out = (level >= Level::Error) ? detail::console_err() : detail::console_out();
             out << message << std::flush;
         }
 
+        /**
+         * @brief Write a block with one stream write per run of same-stream lines
+         *
+         * A block of Info lines reaches stdout in a single write; an Error line
+         * in the middle splits it into stdout, stderr, stdout runs, keeping order.
+         */
+        void write_block(const LogBlock &block) override {
+            std::ostream *run_stream = nullptr;
+            size_t run_begin = 0, run_end = 0;
+            auto flush_run = [&] {
+                if (run_stream && run_end > run_begin) {
+                    run_stream->write(block.text.data() + run_begin, static_cast<std::streamsize>(run_end - run_begin));
+                    *run_stream << std::flush;
+                }
+            };
+
+            for (const auto &line : block.lines) {
+                if (!should_log(line.level)) {
+                    continue;
+                }
+                std::ostream *stream = (line.level >= Level::Error) ? &detail::console_err() : &detail::console_out();
+                if (stream != run_stream || line.begin != run_end) {
+                    flush_run();
+                    run_stream = stream;
+                    run_begin = line.begin;
+                }
+                run_end = line.end;
+            }
+            flush_run();
+        }
+
         /**
          * @brief Flush console output
          */
         void flush() override {
-            std::cout << std::flush;
-            std::cerr << std::flush;
+            detail::console_out() << std::flush;
+            detail::console_err() << std::flush;
+        }
+
+        /**
+         * @brief Touch both streams so their sentries and locale facets are set up
+         */
+        void warm_up() override {
+            detail::console_out() << "" << std::flush;
+            detail::console_err() << "" << std::flush;
         }
     };
 
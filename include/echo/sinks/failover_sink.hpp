@@ -0,0 +1,454 @@
+#pragma once
+
+/**
+ * @file sinks/failover_sink.hpp
+ * @brief Failover chain of sinks with latency and error SLOs
+ *
+ * Only available when compiled with -DECHO_ENABLE_FAILOVER_SINK
+ */
+
+#include <echo/sinks/sink.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace echo {
+
+    /**
+     * @brief Service level objective for a sink in a failover chain
+     */
+    struct FailoverPolicy {
+        std::chrono::nanoseconds max_p99{std::chrono::milliseconds(1)}; ///< p99 write latency limit
+        double max_error_rate = 0.0;                                    ///< Error fraction allowed in the window
+        size_t window = 128;                                            ///< Writes kept per child for p99/error rate
+        size_t min_samples = 16;                                        ///< Samples needed before latency is judged
+        std::chrono::milliseconds retry_interval{5000};                 ///< Cool-down before probing a failed sink
+        size_t recovery_probes = 8;                                     ///< Consecutive good probes to fail back
+    };
+
+    /**
+     * @brief Why a failover chain changed its active sink
+     */
+    enum class FailoverReason {
+        Latency,  ///< Active sink's p99 write latency exceeded the SLO
+        Errors,   ///< Active sink threw, or reported unhealthy, above the error SLO
+        Recovered ///< A higher-priority sink passed its recovery probes
+    };
+
+    /**
+     * @brief A change of active sink, reported to the transition callback
+     */
+    struct FailoverTransition {
+        size_t from;                     ///< Previously active child index
+        size_t to;                       ///< Newly active child index
+        FailoverReason reason;           ///< Cause of the transition
+        std::chrono::nanoseconds p99{0}; ///< p99 of the sink being left (0 on recovery)
+        double error_rate = 0.0;         ///< Error rate of the sink being left
+    };
+
+    /**
+     * @brief Per-child counters and window statistics
+     */
+    struct FailoverChildStats {
+        uint64_t writes = 0;             ///< Records written (including probes)
+        uint64_t errors = 0;             ///< Writes that threw or left the sink unhealthy
+        std::chrono::nanoseconds p99{0}; ///< p99 latency over the current window
+        double error_rate = 0.0;         ///< Error rate over the current window
+        bool failed = false;             ///< Currently considered failed
+    };
+
+    /**
+     * @brief Snapshot of a failover chain's state
+     */
+    struct FailoverStats {
+        size_t active = 0;                        ///< Index of the sink receiving records
+        uint64_t failovers = 0;                   ///< Switches away from a failing sink
+        uint64_t failbacks = 0;                   ///< Switches back to a recovered sink
+        std::vector<FailoverChildStats> children; ///< One entry per child, in priority order
+    };
+
+    /**
+     * @brief Failover sink - routes records to the first healthy sink of a chain
+     *
+     * Children are given in priority order (primary first). Every write to the
+     * active child is timed, and the child's p99 latency and error rate are kept
+     * over a sliding window. When the active child breaches its FailoverPolicy the
+     * chain switches to the next child; a record whose write failed is re-sent to
+     * the new active child (at-least-once). The failed child is first told to
+     * discard it (Sink::discard_last_write()), so a child with a retry buffer,
+     * like NetworkSink, does not deliver it again after reconnecting.
+     *
+     * After retry_interval, a failed higher-priority child is probed with live
+     * records. Each probe that succeeds within the SLO counts towards recovery;
+     * a failing probe is re-sent to the active child and restarts the cool-down.
+     * After recovery_probes consecutive good probes the chain fails back.
+     *
+     * Errors are writes that throw or after which Sink::healthy() is false.
+     *
+     * FailoverSink is itself a Sink, so it can be registered, nested, or wrapped
+     * like any other sink.
+     *
+     * Example:
+     *   auto net = std::make_shared<NetworkSink>("collector", 5140);
+     *   auto spool = std::make_shared<FileSink>("/var/spool/app.log");
+     *   auto chain = std::make_shared<FailoverSink>(std::vector<SinkPtr>{net, spool});
+     *   chain->set_transition_callback([](const FailoverTransition &t) { metrics.bump(t.to); });
+     *   echo::add_sink(chain);
+     *
+     * The transition callback runs on the logging thread while the log mutex is
+     * held: it must not log through echo.
+     */
+    class FailoverSink : public Sink {
+      public:
+        using TransitionCallback = std::function<void(const FailoverTransition &)>;
+
+      private:
+        using clock = std::chrono::steady_clock;
+
+        /**
+         * @brief Sliding window and state for one child
+         */
+        struct Child {
+            SinkPtr sink;
+            FailoverPolicy policy;
+            std::vector<int64_t> latencies; // ring buffer, ns
+            std::vector<uint8_t> failures;  // ring buffer, parallel to latencies
+            size_t next = 0;
+            size_t samples = 0;
+            size_t window_errors = 0;
+            uint64_t writes = 0;
+            uint64_t errors = 0;
+            bool failed = false;
+            clock::time_point retry_at{};
+            size_t good_probes = 0;
+        };
+
+        std::vector<Child> children_;
+        size_t active_ = 0;
+        uint64_t failovers_ = 0;
+        uint64_t failbacks_ = 0;
+        TransitionCallback on_transition_;
+        std::vector<int64_t> scratch_; // reused for p99 selection
+        mutable std::mutex mutex_;
+
+        /**
+         * @brief Write to a child and time it
+         * @return true if the write neither threw nor left the sink unhealthy
+         */
+        static bool timed_write(Child &child, Level level, const std::string &message, int64_t &elapsed_ns) {
+            bool ok = true;
+            auto start = clock::now();
+            try {
+                child.sink->write(level, message);
+                ok = child.sink->healthy();
+            } catch (const std::exception &) {
+                ok = false;
+            }
+            elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+            ++child.writes;
+            if (!ok) {
+                ++child.errors;
+            }
+            return ok;
+        }
+
+        static void record_sample(Child &child, int64_t elapsed_ns, bool ok) {
+            const size_t window = child.latencies.size();
+            if (child.samples == window) {
+                child.window_errors -= child.failures[child.next];
+            } else {
+                ++child.samples;
+            }
+            child.latencies[child.next] = elapsed_ns;
+            child.failures[child.next] = ok ? 0 : 1;
+            child.window_errors += ok ? 0 : 1;
+            child.next = (child.next + 1) % window;
+        }
+
+        static void reset_window(Child &child) {
+            child.next = 0;
+            child.samples = 0;
+            child.window_errors = 0;
+        }
+
+        int64_t window_p99(const Child &child) {
+            if (child.samples == 0) {
+                return 0;
+            }
+            scratch_.assign(child.latencies.begin(), child.latencies.begin() + child.samples);
+            size_t idx = (child.samples * 99) / 100;
+            if (idx >= child.samples) {
+                idx = child.samples - 1;
+            }
+            std::nth_element(scratch_.begin(), scratch_.begin() + idx, scratch_.end());
+            return scratch_[idx];
+        }
+
+        static double window_error_rate(const Child &child) {
+            return child.samples ? static_cast<double>(child.window_errors) / static_cast<double>(child.samples) : 0.0;
+        }
+
+        void transition(size_t to, FailoverReason reason, int64_t p99, double error_rate) {
+            FailoverTransition event{active_, to, reason, std::chrono::nanoseconds(p99), error_rate};
+            active_ = to;
+            if (reason == FailoverReason::Recovered) {
+                ++failbacks_;
+            } else {
+                ++failovers_;
+            }
+            if (on_transition_) {
+                on_transition_(event);
+            }
+        }
+
+        /**
+         * @brief Mark the active child failed and move to the next one, if any
+         * @return true if the active child changed
+         */
+        bool fail_active(FailoverReason reason, int64_t p99, double error_rate) {
+            Child &child = children_[active_];
+            child.failed = true;
+            child.good_probes = 0;
+            child.retry_at = clock::now() + child.policy.retry_interval;
+            if (active_ + 1 >= children_.size()) {
+                return false; // last resort: keep writing here
+            }
+            transition(active_ + 1, reason, p99, error_rate);
+            return true;
+        }
+
+        /**
+         * @brief Find a failed higher-priority child whose cool-down has expired
+         * @return Child index, or active_ if none is due
+         */
+        size_t due_probe() const {
+            auto now = clock::now();
+            for (size_t i = 0; i < active_; ++i) {
+                if (children_[i].failed && now >= children_[i].retry_at) {
+                    return i;
+                }
+            }
+            return active_;
+        }
+
+        /**
+         * @brief Send a record to a recovering child
+         * @return true if the probe delivered the record
+         */
+        bool probe(size_t index, Level level, const std::string &message) {
+            Child &child = children_[index];
+            int64_t elapsed = 0;
+            bool ok = timed_write(child, level, message, elapsed) && elapsed <= child.policy.max_p99.count();
+
+            if (!ok) {
+                // The record goes to the active child instead
+                child.sink->discard_last_write();
+                child.good_probes = 0;
+                child.retry_at = clock::now() + child.policy.retry_interval;
+                return false;
+            }
+
+            if (++child.good_probes >= child.policy.recovery_probes) {
+                child.failed = false;
+                child.good_probes = 0;
+                reset_window(child);
+                for (size_t i = index + 1; i < children_.size(); ++i) {
+                    children_[i].failed = false;
+                }
+                transition(index, FailoverReason::Recovered, 0, 0.0);
+            }
+            return true;
+        }
+
+      public:
+        /**
+         * @brief Construct a failover chain
+         * @param children Sinks in priority order (primary first); null entries are ignored
+         * @param policy SLO applied to every child
+         */
+        explicit FailoverSink(std::vector<SinkPtr> children, const FailoverPolicy &policy = {}) {
+            for (auto &sink : children) {
+                add_child(std::move(sink), policy);
+            }
+        }
+
+        /**
+         * @brief Append a lower-priority child with its own SLO
+         * @param sink Sink to append (ignored if null)
+         * @param policy SLO for this child
+         */
+        void add_child(SinkPtr sink, const FailoverPolicy &policy = {}) {
+            if (!sink) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            Child child;
+            child.sink = std::move(sink);
+            child.policy = policy;
+            child.policy.window = std::max<size_t>(policy.window, 1);
+            child.latencies.assign(child.policy.window, 0);
+            child.failures.assign(child.policy.window, 0);
+            children_.push_back(std::move(child));
+        }
+
+        /**
+         * @brief Write a record to the active child, failing over if it breaches its SLO
+         * @param level Log level
+         * @param message Formatted message
+         */
+        void write(Level level, const std::string &message) override {
+            if (!should_log(level)) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (children_.empty()) {
+                return;
+            }
+
+            // A record the recovering child filters out is no probe: it stays due for the next record
+            size_t probe_index = due_probe();
+            if (probe_index != active_ && children_[probe_index].sink->should_log(level) &&
+                probe(probe_index, level, message)) {
+                return;
+            }
+
+            Child &child = children_[active_];
+            if (!child.sink->should_log(level)) {
+                return;
+            }
+
+            int64_t elapsed = 0;
+            bool ok = timed_write(child, level, message, elapsed);
+            record_sample(child, elapsed, ok);
+
+            if (ok) {
+                child.failed = false; // last child in the chain recovered in place
+            }
+
+            double error_rate = window_error_rate(child);
+            if (!ok && error_rate > child.policy.max_error_rate) {
+                if (fail_active(FailoverReason::Errors, window_p99(child), error_rate)) {
+                    // The failed write may not have been delivered: re-send it, and make sure the
+                    // failed sink does not deliver it later from a retry buffer
+                    child.sink->discard_last_write();
+                    Child &next = children_[active_];
+                    int64_t next_elapsed = 0;
+                    bool next_ok = timed_write(next, level, message, next_elapsed);
+                    record_sample(next, next_elapsed, next_ok);
+                }
+                return;
+            }
+
+            if (child.samples >= child.policy.min_samples && elapsed > child.policy.max_p99.count()) {
+                int64_t p99 = window_p99(child);
+                if (p99 > child.policy.max_p99.count()) {
+                    fail_active(FailoverReason::Latency, p99, error_rate);
+                }
+            }
+        }
+
+        /**
+         * @brief Flush every child
+         */
+        void flush() override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto &child : children_) {
+                child.sink->flush();
+            }
+        }
+
+        /**
+         * @brief Warm up every child
+         */
+        void warm_up() override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto &child : children_) {
+                child.sink->warm_up();
+            }
+        }
+
+        /**
+         * @brief Pass the memory budget to every child
+         */
+        void set_memory_budget(double scale) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto &child : children_) {
+                child.sink->set_memory_budget(scale);
+            }
+        }
+
+        /**
+         * @brief Healthy while the active child is healthy
+         */
+        [[nodiscard]] bool healthy() const override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return !children_.empty() && children_[active_].sink->healthy();
+        }
+
+        /**
+         * @brief Set formatter on this sink and every child
+         */
+        void set_formatter(FormatterPtr formatter) override {
+            Sink::set_formatter(formatter);
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto &child : children_) {
+                child.sink->set_formatter(formatter);
+            }
+        }
+
+        /**
+         * @brief Set a callback invoked on every failover and failback
+         * @param callback Called with the transition; must not log through echo
+         */
+        void set_transition_callback(TransitionCallback callback) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            on_transition_ = std::move(callback);
+        }
+
+        /**
+         * @brief Get the index of the child currently receiving records
+         */
+        [[nodiscard]] size_t active_index() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return active_;
+        }
+
+        /**
+         * @brief Get a snapshot of counters and window statistics
+         */
+        [[nodiscard]] FailoverStats stats() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            FailoverStats result;
+            result.active = active_;
+            result.failovers = failovers_;
+            result.failbacks = failbacks_;
+            result.children.reserve(children_.size());
+            for (const auto &child : children_) {
+                FailoverChildStats cs;
+                cs.writes = child.writes;
+                cs.errors = child.errors;
+                cs.p99 = std::chrono::nanoseconds(window_p99(child));
+                cs.error_rate = window_error_rate(child);
+                cs.failed = child.failed;
+                result.children.push_back(cs);
+            }
+            return result;
+        }
+
+        /**
+         * @brief Get number of children in the chain
+         */
+        [[nodiscard]] size_t size() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return children_.size();
+        }
+    };
+
+} // namespace echo
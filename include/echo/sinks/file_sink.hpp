@@ -255,6 +255,14 @@ namespace echo {
             }
         }
 
+        /**
+         * @brief Check that the file is open and the last write succeeded
+         */
+        [[nodiscard]] bool healthy() const override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return file_.is_open() && file_.good();
+        }
+
         /**
          * @brief Enable log rotation
          * @param max_size Maximum file size in bytes before rotation
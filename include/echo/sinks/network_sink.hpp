@@ -9,9 +9,10 @@
 
 #include <echo/sinks/sink.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <mutex>
-#include <queue>
+#include <deque>
 #include <string>
 
 // Platform-specific socket includes
@@ -56,8 +57,10 @@ namespace echo {
         int socket_ = -1;
         bool connected_ = false;
         mutable std::mutex mutex_;
-        std::queue<std::string> buffer_;
+        std::deque<std::string> buffer_;
         size_t max_buffer_size_ = 100;
+        double budget_scale_ = 1.0; // Memory governor's factor on max_buffer_size_
+        bool last_buffered_ = false; // The last write() queued its message in buffer_
         std::chrono::steady_clock::time_point last_connect_attempt_;
         std::chrono::seconds reconnect_interval_{5};
 
@@ -189,13 +192,33 @@ namespace echo {
         void flush_buffer() {
             while (!buffer_.empty() && connected_) {
                 if (send_message(buffer_.front())) {
-                    buffer_.pop();
+                    buffer_.pop_front();
                 } else {
                     break;
                 }
             }
         }
 
+        /**
+         * @brief Buffer limit after the memory budget (at least 1 unless buffering is disabled)
+         */
+        [[nodiscard]] size_t buffer_limit() const {
+            if (max_buffer_size_ == 0) {
+                return 0;
+            }
+            return std::max<size_t>(1, static_cast<size_t>(static_cast<double>(max_buffer_size_) * budget_scale_));
+        }
+
+        /**
+         * @brief Drop the oldest buffered messages beyond the current limit
+         */
+        void trim_buffer() {
+            size_t limit = buffer_limit();
+            while (buffer_.size() > limit) {
+                buffer_.pop_front();
+            }
+        }
+
       public:
         /**
          * @brief Construct a network sink
@@ -228,6 +251,7 @@ namespace echo {
             std::lock_guard<std::mutex> lock(mutex_);
 
             std::string clean_message = strip_ansi(message);
+            last_buffered_ = false;
 
             // Try to send immediately
             if (send_message(clean_message)) {
@@ -235,13 +259,28 @@ namespace echo {
                 flush_buffer();
             } else {
                 // Failed, buffer the message
-                if (buffer_.size() < max_buffer_size_) {
-                    buffer_.push(clean_message);
+                if (buffer_.size() < buffer_limit()) {
+                    buffer_.push_back(std::move(clean_message));
+                    last_buffered_ = true;
                 }
                 // If buffer is full, oldest messages are dropped
             }
         }
 
+        /**
+         * @brief Drop the message of the last write() if it was buffered rather than sent
+         *
+         * FailoverSink re-sends that message elsewhere, so it must not go out
+         * again when the connection comes back.
+         */
+        void discard_last_write() override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (last_buffered_ && !buffer_.empty()) {
+                buffer_.pop_back();
+            }
+            last_buffered_ = false;
+        }
+
         /**
          * @brief Flush any buffered messages
          */
@@ -250,6 +289,19 @@ namespace echo {
             flush_buffer();
         }
 
+        /**
+         * @brief Resolve and connect now instead of on the first write
+         *
+         * Bypasses the reconnect rate limit, since nothing has been attempted yet.
+         */
+        void warm_up() override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!connected_) {
+                last_connect_attempt_ = std::chrono::steady_clock::now() - reconnect_interval_;
+                connect();
+            }
+        }
+
         /**
          * @brief Set maximum buffer size
          * @param size Maximum number of messages to buffer
@@ -259,6 +311,23 @@ namespace echo {
             max_buffer_size_ = size;
         }
 
+        /**
+         * @brief Scale the buffer limit under memory pressure, dropping the oldest messages on shrink
+         */
+        void set_memory_budget(double scale) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            budget_scale_ = scale;
+            trim_buffer();
+        }
+
+        /**
+         * @brief Get the current buffer limit (configured size scaled by the memory budget)
+         */
+        [[nodiscard]] size_t get_buffer_limit() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return buffer_limit();
+        }
+
         /**
          * @brief Set reconnection interval
          * @param seconds Seconds between reconnection attempts
@@ -277,6 +346,11 @@ namespace echo {
             return connected_;
         }
 
+        /**
+         * @brief Healthy while connected (messages are being sent, not buffered)
+         */
+        [[nodiscard]] bool healthy() const override { return is_connected(); }
+
         /**
          * @brief Get number of buffered messages
          * @return Buffer size
@@ -7,6 +7,7 @@
 
 #include <echo/core/level.hpp>
 #include <echo/core/mutex.hpp>
+#include <echo/core/record_size.hpp>
 #include <echo/formatters/formatter.hpp>
 #include <echo/formatters/pattern.hpp>
 #include <echo/sinks/console_sink.hpp>
@@ -37,6 +38,9 @@ namespace echo {
             std::vector<SinkPtr> sinks_;
             mutable std::mutex mutex_;
             bool initialized_ = false;
+            std::string capped_line_; // Scratch for sinks with a record size cap (guarded by mutex_)
+            LogBlock capped_block_;
+            double memory_budget_ = 1.0; // Last scale from the memory governor, applied to new sinks
 
             /**
              * @brief Initialize default ConsoleSink if no sinks are registered
@@ -51,6 +55,34 @@ namespace echo {
                 }
             }
 
+            /**
+             * @brief Block as a sink with a record size cap receives it
+             * @return block itself if no line exceeds cap, else capped_block_
+             */
+            const LogBlock &cap_block(const LogBlock &block, size_t cap) {
+                bool over = false;
+                for (const auto &line : block.lines) {
+                    over = over || exceeds_record_size(
+                                       std::string_view(block.text).substr(line.begin, line.end - line.begin), cap);
+                }
+                if (!over) {
+                    return block;
+                }
+                capped_block_.clear();
+                for (const auto &line : block.lines) {
+                    std::string_view text = std::string_view(block.text).substr(line.begin, line.end - line.begin);
+                    size_t begin = capped_block_.text.size();
+                    if (exceeds_record_size(text, cap)) {
+                        truncate_record(text, cap, capped_line_);
+                        capped_block_.text += capped_line_;
+                    } else {
+                        capped_block_.text.append(text.data(), text.size());
+                    }
+                    capped_block_.lines.push_back({line.level, begin, capped_block_.text.size()});
+                }
+                return capped_block_;
+            }
+
           public:
             /**
              * @brief Get the singleton instance
@@ -68,6 +100,9 @@ namespace echo {
                 if (!sink)
                     return;
                 std::lock_guard<std::mutex> lock(mutex_);
+                if (memory_budget_ != 1.0) {
+                    sink->set_memory_budget(memory_budget_);
+                }
                 sinks_.push_back(sink);
             }
 
@@ -100,7 +135,26 @@ namespace echo {
                 ensure_default_sink();
                 for (auto &sink : sinks_) {
                     if (sink && sink->should_log(level)) {
-                        sink->write(level, message);
+                        if (exceeds_record_size(message, sink->max_record_size())) {
+                            truncate_record(message, sink->max_record_size(), capped_line_);
+                            sink->write(level, capped_line_);
+                        } else {
+                            sink->write(level, message);
+                        }
+                    }
+                }
+            }
+
+            /**
+             * @brief Write a block of lines to all registered sinks, one unit per sink
+             * @param block Formatted lines
+             */
+            void write_block_all(const LogBlock &block) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ensure_default_sink();
+                for (auto &sink : sinks_) {
+                    if (sink) {
+                        sink->write_block(sink->max_record_size() ? cap_block(block, sink->max_record_size()) : block);
                     }
                 }
             }
@@ -117,6 +171,33 @@ namespace echo {
                 }
             }
 
+            /**
+             * @brief Create the default sink and warm up every registered sink
+             */
+            void warm_up() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ensure_default_sink();
+                for (auto &sink : sinks_) {
+                    if (sink) {
+                        sink->warm_up();
+                    }
+                }
+            }
+
+            /**
+             * @brief Scale the buffers of every registered sink, and of sinks added later
+             * @param scale Factor on each sink's configured limits (see Sink::set_memory_budget())
+             */
+            void set_memory_budget_all(double scale) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                memory_budget_ = scale;
+                for (auto &sink : sinks_) {
+                    if (sink) {
+                        sink->set_memory_budget(scale);
+                    }
+                }
+            }
+
             /**
              * @brief Get number of registered sinks
              * @return Number of sinks
@@ -0,0 +1,527 @@
+#pragma once
+
+/**
+ * @file sinks/reliable_udp_sink.hpp
+ * @brief UDP output sink with sequence numbers and NACK-driven retransmit
+ *
+ * Only available when compiled with -DECHO_ENABLE_RELIABLE_UDP_SINK
+ * Only works on Unix/Linux systems
+ */
+
+#include <echo/sinks/sink.hpp>
+#include <echo/transport/reliable_udp.hpp>
+
+#ifdef __unix__
+#include <netdb.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#endif
+
+namespace echo {
+
+#ifdef __unix__
+
+    /**
+     * @brief Sender counters
+     */
+    struct ReliableUdpStats {
+        uint64_t datagrams = 0;      ///< DATA datagrams sent (first transmissions)
+        uint64_t records = 0;        ///< Records sent
+        uint64_t retransmits = 0;    ///< Datagrams resent after a NACK
+        uint64_t nacks_received = 0; ///< NACK datagrams received
+        uint64_t unrecoverable = 0;  ///< NACKed datagrams already evicted from the window
+        uint64_t send_errors = 0;    ///< send() failures (the datagram stays retransmittable)
+    };
+
+    /**
+     * @brief Reliable UDP sink - batched datagrams with NACK retransmit
+     *
+     * Features:
+     * - Records batched into datagrams up to set_max_datagram_size() bytes
+     * - Per-process stream id and sequence numbers on every datagram
+     * - Bounded retransmit window answering receiver NACKs
+     * - Heartbeat on flush() and after idle periods so the receiver can detect tail loss
+     * - ANSI code stripping
+     *
+     * A batch is sent when it is full, when its linger time has passed, or on
+     * flush(). A housekeeping thread calls service() every 10 ms, so the last
+     * batch of a burst is sent and heartbeats go out even when no more records
+     * follow. set_housekeeping_interval(0) stops the thread for callers that
+     * drive service() from their own loop. NACKs are also served on every
+     * write() and flush().
+     *
+     * Pair with ReliableUdpReceiver on the collector side.
+     *
+     * Example:
+     *   auto udp = std::make_shared<ReliableUdpSink>("collector", 5141);
+     *   udp->set_window_size(4096);  // Keep the last 4096 datagrams for retransmit
+     *   echo::add_sink(udp);
+     */
+    class ReliableUdpSink : public Sink {
+      public:
+        /// Test hook: return true to drop a datagram instead of sending it
+        using DropInjector = std::function<bool(uint64_t seq, bool retransmit)>;
+
+      private:
+        using clock = std::chrono::steady_clock;
+
+        std::string host_;
+        int port_;
+        int socket_ = -1;
+        uint64_t stream_id_;
+        uint64_t next_seq_ = 1;
+        mutable std::mutex mutex_;
+
+        std::string batch_;
+        uint16_t batch_records_ = 0;
+        clock::time_point batch_started_;
+        size_t max_datagram_size_ = 1400;
+        std::chrono::microseconds linger_{1000};
+
+        std::deque<std::pair<uint64_t, std::string>> window_;
+        size_t window_size_ = 1024;
+        double budget_scale_ = 1.0; // Memory governor's factor on window_size_
+
+        clock::time_point last_data_{};      // Last first transmission of a DATA datagram
+        clock::time_point last_heartbeat_{}; // Last heartbeat sent
+        std::chrono::milliseconds heartbeat_interval_{100};
+        uint64_t heartbeat_seq_ = 0; // Tail seq the idle heartbeats are for
+        int idle_heartbeats_ = 0;    // Idle heartbeats sent for heartbeat_seq_
+
+        std::chrono::milliseconds housekeeping_interval_{10};
+        bool stopping_ = false;
+        std::condition_variable housekeeping_wake_;
+        std::thread housekeeper_;
+
+        DropInjector drop_;
+        std::string nack_buffer_ = std::string(detail::RUDP_MAX_DATAGRAM, '\0');
+        ReliableUdpStats stats_;
+
+        /**
+         * @brief Create the socket and connect it to the receiver
+         */
+        bool open_socket() {
+            struct addrinfo hints = {}, *result = nullptr;
+            hints.ai_family = AF_INET;
+            hints.ai_socktype = SOCK_DGRAM;
+
+            if (getaddrinfo(host_.c_str(), std::to_string(port_).c_str(), &hints, &result) != 0) {
+                return false;
+            }
+
+            socket_ = ::socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+            // Connecting a UDP socket fixes the peer, so NACKs from elsewhere are ignored
+            if (socket_ != -1 && ::connect(socket_, result->ai_addr, result->ai_addrlen) != 0) {
+                ::close(socket_);
+                socket_ = -1;
+            }
+
+            freeaddrinfo(result);
+            return socket_ != -1;
+        }
+
+        static uint64_t make_stream_id() {
+            std::random_device rd;
+            uint64_t id = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+            id ^= static_cast<uint64_t>(::getpid()) << 16;
+            id ^= static_cast<uint64_t>(clock::now().time_since_epoch().count());
+            return id;
+        }
+
+        /**
+         * @brief Send (or drop, when the injector says so) one datagram
+         */
+        void transmit(uint64_t seq, const std::string &datagram, bool retransmit) {
+            if (drop_ && drop_(seq, retransmit)) {
+                return;
+            }
+            if (socket_ == -1 || ::send(socket_, datagram.data(), datagram.size(), MSG_DONTWAIT) < 0) {
+                ++stats_.send_errors;
+            }
+        }
+
+        /**
+         * @brief Window limit after the memory budget (at least 1)
+         */
+        [[nodiscard]] size_t window_limit() const {
+            return std::max<size_t>(1, static_cast<size_t>(static_cast<double>(window_size_) * budget_scale_));
+        }
+
+        /**
+         * @brief Evict the oldest datagrams beyond the current limit
+         */
+        void trim_window() {
+            size_t limit = window_limit();
+            while (window_.size() > limit) {
+                window_.pop_front();
+            }
+        }
+
+        /**
+         * @brief Seal the current batch into a datagram and send it
+         */
+        void send_batch() {
+            if (batch_records_ == 0) {
+                return;
+            }
+
+            uint64_t seq = next_seq_++;
+            std::string datagram;
+            datagram.reserve(detail::RUDP_HEADER_SIZE + batch_.size());
+            detail::rudp_put_header(datagram, detail::RUDP_DATA, batch_records_, stream_id_, seq);
+            datagram += batch_;
+
+            ++stats_.datagrams;
+            stats_.records += batch_records_;
+            batch_.clear();
+            batch_records_ = 0;
+
+            if (window_.size() >= window_limit()) {
+                window_.pop_front();
+            }
+            window_.emplace_back(seq, std::move(datagram));
+            transmit(seq, window_.back().second, false);
+            last_data_ = clock::now();
+        }
+
+        /**
+         * @brief Tell the receiver the last sequence number, so it can NACK a lost tail
+         */
+        void send_heartbeat() {
+            if (socket_ == -1 || next_seq_ == 1) {
+                return;
+            }
+            std::string datagram;
+            detail::rudp_put_header(datagram, detail::RUDP_HEARTBEAT, 0, stream_id_, next_seq_ - 1);
+            ::send(socket_, datagram.data(), datagram.size(), MSG_DONTWAIT);
+            last_heartbeat_ = clock::now();
+        }
+
+        /**
+         * @brief Send a batch whose linger expired and heartbeat an idle tail (caller holds mutex_)
+         */
+        void housekeep() {
+            auto now = clock::now();
+            if (batch_records_ > 0 && now - batch_started_ >= linger_) {
+                send_batch();
+            }
+            if (next_seq_ > 1 && now - last_data_ >= heartbeat_interval_) {
+                if (heartbeat_seq_ != next_seq_ - 1) {
+                    heartbeat_seq_ = next_seq_ - 1;
+                    idle_heartbeats_ = 0;
+                }
+                if (idle_heartbeats_ < detail::RUDP_HEARTBEAT_REPEATS && now - last_heartbeat_ >= heartbeat_interval_) {
+                    send_heartbeat();
+                    ++idle_heartbeats_;
+                }
+            }
+            service_nacks();
+        }
+
+        void stop_housekeeping(std::unique_lock<std::mutex> &lock) {
+            if (!housekeeper_.joinable()) {
+                return;
+            }
+            stopping_ = true;
+            lock.unlock();
+            housekeeping_wake_.notify_all();
+            housekeeper_.join();
+            lock.lock();
+            stopping_ = false;
+        }
+
+        void start_housekeeping() {
+            if (housekeeping_interval_.count() == 0 || housekeeper_.joinable()) {
+                return;
+            }
+            housekeeper_ = std::thread([this] {
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (!stopping_) {
+                    housekeeping_wake_.wait_for(lock, housekeeping_interval_, [this] { return stopping_; });
+                    if (!stopping_) {
+                        housekeep();
+                    }
+                }
+            });
+        }
+
+        /**
+         * @brief Resend one datagram from the retransmit window
+         */
+        void retransmit(uint64_t seq) {
+            if (seq >= next_seq_) {
+                return;
+            }
+            if (window_.empty() || seq < window_.front().first) {
+                ++stats_.unrecoverable;
+                return;
+            }
+            // The window holds consecutive sequence numbers
+            const auto &entry = window_[seq - window_.front().first];
+            ++stats_.retransmits;
+            transmit(entry.first, entry.second, true);
+        }
+
+        /**
+         * @brief Read all pending NACKs and answer them
+         */
+        void service_nacks() {
+            if (socket_ == -1) {
+                return;
+            }
+            while (true) {
+                ssize_t n = ::recv(socket_, nack_buffer_.data(), nack_buffer_.size(), MSG_DONTWAIT);
+                if (n <= 0) {
+                    return;
+                }
+
+                const auto *data = reinterpret_cast<const unsigned char *>(nack_buffer_.data());
+                detail::RudpHeader header;
+                if (!detail::rudp_parse_header(data, static_cast<size_t>(n), header) ||
+                    header.type != detail::RUDP_NACK || header.stream != stream_id_) {
+                    continue;
+                }
+                ++stats_.nacks_received;
+
+                size_t pos = detail::RUDP_HEADER_SIZE;
+                for (uint16_t i = 0; i < header.count && pos + 16 <= static_cast<size_t>(n); ++i, pos += 16) {
+                    // Clamp to what was sent; stale or bogus ranges must not loop over evicted history
+                    uint64_t first = std::max<uint64_t>(detail::rudp_get_u64(data + pos), 1);
+                    uint64_t last = std::min(detail::rudp_get_u64(data + pos + 8), next_seq_ - 1);
+                    if (first > last) {
+                        continue;
+                    }
+                    uint64_t oldest = window_.empty() ? next_seq_ : window_.front().first;
+                    if (first < oldest) {
+                        uint64_t evicted_end = std::min(last, oldest - 1);
+                        stats_.unrecoverable += evicted_end - first + 1;
+                        first = evicted_end + 1;
+                    }
+                    for (uint64_t seq = first; seq <= last; ++seq) {
+                        retransmit(seq);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Strip ANSI escape codes from string
+         */
+        std::string strip_ansi(const std::string &str) const {
+            std::string result;
+            result.reserve(str.size());
+
+            bool in_escape = false;
+            for (size_t i = 0; i < str.size(); ++i) {
+                if (str[i] == '\033' && i + 1 < str.size() && str[i + 1] == '[') {
+                    in_escape = true;
+                    ++i;
+                    continue;
+                }
+                if (in_escape) {
+                    if (str[i] == 'm') {
+                        in_escape = false;
+                    }
+                    continue;
+                }
+                result += str[i];
+            }
+            return result;
+        }
+
+      public:
+        /**
+         * @brief Construct a reliable UDP sink
+         * @param host Receiver hostname or IP
+         * @param port Receiver port
+         */
+        ReliableUdpSink(const std::string &host, int port)
+            : host_(host), port_(port), stream_id_(make_stream_id()) {
+            open_socket();
+            std::lock_guard<std::mutex> lock(mutex_);
+            start_housekeeping();
+        }
+
+        ~ReliableUdpSink() override {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                stop_housekeeping(lock);
+            }
+            flush();
+            if (socket_ != -1) {
+                ::close(socket_);
+            }
+        }
+
+        // Prevent copying
+        ReliableUdpSink(const ReliableUdpSink &) = delete;
+        ReliableUdpSink &operator=(const ReliableUdpSink &) = delete;
+
+        /**
+         * @brief Add a message to the current batch
+         * @param level Log level
+         * @param message Formatted message
+         */
+        void write(Level level, const std::string &message) override {
+            if (!should_log(level)) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            service_nacks();
+
+            std::string clean_message = strip_ansi(message);
+            size_t max_payload = detail::RUDP_MAX_DATAGRAM - detail::RUDP_HEADER_SIZE - detail::RUDP_RECORD_OVERHEAD;
+            if (clean_message.size() > max_payload) {
+                clean_message.resize(max_payload);
+            }
+
+            size_t record_size = detail::RUDP_RECORD_OVERHEAD + clean_message.size();
+            if (batch_records_ > 0 && (detail::RUDP_HEADER_SIZE + batch_.size() + record_size > max_datagram_size_ ||
+                                       batch_records_ == UINT16_MAX)) {
+                send_batch();
+            }
+
+            if (batch_records_ == 0) {
+                batch_started_ = clock::now();
+            }
+            batch_ += static_cast<char>(level);
+            detail::rudp_put_u32(batch_, static_cast<uint32_t>(clean_message.size()));
+            batch_ += clean_message;
+            ++batch_records_;
+
+            if (detail::RUDP_HEADER_SIZE + batch_.size() >= max_datagram_size_ ||
+                clock::now() - batch_started_ >= linger_) {
+                send_batch();
+            }
+        }
+
+        /**
+         * @brief Send the current batch and a heartbeat, then serve NACKs
+         */
+        void flush() override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            send_batch();
+            send_heartbeat();
+            service_nacks();
+        }
+
+        /**
+         * @brief Housekeeping without writing: send a lingering batch, heartbeat an idle tail, serve NACKs
+         *
+         * Run by the housekeeping thread; call it periodically yourself after
+         * set_housekeeping_interval(0). An idle tail gets up to three
+         * heartbeats, heartbeat_interval apart.
+         */
+        void service() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            housekeep();
+        }
+
+        /**
+         * @brief Set how often the housekeeping thread runs service() (0 stops the thread)
+         */
+        void set_housekeeping_interval(std::chrono::milliseconds interval) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            stop_housekeeping(lock);
+            housekeeping_interval_ = interval;
+            start_housekeeping();
+        }
+
+        /**
+         * @brief Set how long the sender must be idle before a heartbeat (default 100 ms)
+         */
+        void set_heartbeat_interval(std::chrono::milliseconds interval) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            heartbeat_interval_ = interval;
+        }
+
+        /**
+         * @brief Set the datagram size that triggers a send (default 1400, below a typical MTU)
+         */
+        void set_max_datagram_size(size_t bytes) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            max_datagram_size_ = std::min(std::max(bytes, detail::RUDP_HEADER_SIZE + 1), detail::RUDP_MAX_DATAGRAM);
+        }
+
+        /**
+         * @brief Set how long a partial batch may wait for more records (0 sends every record)
+         */
+        void set_linger(std::chrono::microseconds linger) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            linger_ = linger;
+        }
+
+        /**
+         * @brief Set how many sent datagrams are kept for retransmit
+         */
+        void set_window_size(size_t datagrams) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            window_size_ = std::max<size_t>(datagrams, 1);
+            trim_window();
+        }
+
+        /**
+         * @brief Scale the retransmit window under memory pressure, evicting the oldest datagrams on shrink
+         */
+        void set_memory_budget(double scale) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            budget_scale_ = scale;
+            trim_window();
+        }
+
+        /**
+         * @brief Get the current window limit (configured size scaled by the memory budget)
+         */
+        [[nodiscard]] size_t window_size() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return window_limit();
+        }
+
+        /**
+         * @brief Install a packet-loss injector (for testing)
+         */
+        void set_drop_injector(DropInjector injector) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            drop_ = std::move(injector);
+        }
+
+        /**
+         * @brief Get this sender's stream id
+         */
+        [[nodiscard]] uint64_t stream_id() const { return stream_id_; }
+
+        /**
+         * @brief Get the sequence number of the last sent datagram (0 if none)
+         */
+        [[nodiscard]] uint64_t last_seq() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return next_seq_ - 1;
+        }
+
+        /**
+         * @brief Get counters
+         */
+        [[nodiscard]] ReliableUdpStats stats() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return stats_;
+        }
+
+        /**
+         * @brief Healthy while the socket is open
+         */
+        [[nodiscard]] bool healthy() const override { return socket_ != -1; }
+    };
+
+#endif // __unix__
+
+} // namespace echo
@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 // Forward declare Formatter (will be included by echo.hpp)
 namespace echo {
@@ -18,6 +19,30 @@ namespace echo {
 
 namespace echo {
 
+    /**
+     * @brief Several formatted lines submitted as one unit (see echo::block)
+     */
+    struct LogBlock {
+        /**
+         * @brief One line of the block, as a range of text
+         */
+        struct Line {
+            Level level;  ///< Level of this line
+            size_t begin; ///< Offset of the first byte in text
+            size_t end;   ///< Offset one past the line's last byte (including its newline)
+        };
+
+        std::string text;        ///< All lines, formatted and concatenated
+        std::vector<Line> lines; ///< Line boundaries within text
+
+        [[nodiscard]] bool empty() const noexcept { return lines.empty(); }
+
+        void clear() noexcept {
+            text.clear();
+            lines.clear();
+        }
+    };
+
     /**
      * @brief Abstract base class for all logging sinks
      *
@@ -29,6 +54,8 @@ namespace echo {
      * - FileSink: File output with rotation (requires -DECHO_ENABLE_FILE_SINK)
      * - SyslogSink: Unix syslog (requires -DECHO_ENABLE_SYSLOG_SINK)
      * - NetworkSink: TCP/UDP logging (requires -DECHO_ENABLE_NETWORK_SINK)
+     * - FailoverSink: Primary/secondary chain with latency SLOs (requires -DECHO_ENABLE_FAILOVER_SINK)
+     * - ReliableUdpSink: UDP with NACK retransmit (requires -DECHO_ENABLE_RELIABLE_UDP_SINK)
      *
      * Custom sinks can be created by inheriting from this class.
      */
@@ -59,6 +86,63 @@ namespace echo {
          */
         virtual void flush() = 0;
 
+        /**
+         * @brief Write several lines as one unit
+         * @param block Lines to write
+         *
+         * The default drops the lines this sink filters out and passes the rest
+         * to a single write() at the highest remaining level, so the block lands
+         * contiguously: one stream write for console and file, one send for the
+         * network sinks. Override only if the sink can do better.
+         */
+        virtual void write_block(const LogBlock &block) {
+            std::string filtered;
+            Level level = Level::Trace;
+            const std::string *text = select_block_lines(block, filtered, level);
+            if (text) {
+                write(level, *text);
+            }
+        }
+
+        /**
+         * @brief Eagerly initialize anything the first write would set up lazily
+         *
+         * Called by echo::warm_up() so the first real log call does not pay for
+         * connections, buffer growth, or similar one-time costs. Default: no-op.
+         */
+        virtual void warm_up() {}
+
+        /**
+         * @brief Check whether the sink can currently deliver messages
+         * @return true if the last write reached the destination
+         *
+         * write() does not report errors, so combinators such as FailoverSink
+         * call this after each write to detect a broken destination (closed
+         * file, lost connection). Default: always healthy.
+         */
+        [[nodiscard]] virtual bool healthy() const { return true; }
+
+        /**
+         * @brief Give up the record of the last write() if it is held for later delivery
+         *
+         * Called by FailoverSink before it re-sends a failed record to another
+         * sink. A sink that keeps undeliverable records for a retry (e.g.
+         * NetworkSink while disconnected) drops that record here, so it is not
+         * delivered twice once the sink recovers. Default: no-op.
+         */
+        virtual void discard_last_write() {}
+
+        /**
+         * @brief Scale the sink's buffers and queues to the available memory
+         * @param scale Factor applied to the configured limits (1.0 = as configured)
+         *
+         * Called by the memory governor on every pressure transition: below 1.0
+         * the sink should shrink (dropping the oldest buffered data), above 1.0
+         * it may hold more. The configured limits are kept, so the scale does
+         * not compound. Default: no-op, for sinks without buffers.
+         */
+        virtual void set_memory_budget(double scale) { (void)scale; }
+
         /**
          * @brief Set minimum log level for this sink
          * @param level Minimum level to log
@@ -83,6 +167,21 @@ namespace echo {
             return static_cast<int>(level) >= static_cast<int>(min_level_);
         }
 
+        /**
+         * @brief Cap the size of each record written to this sink
+         * @param bytes Maximum bytes of a formatted line before the truncation marker (0 = unlimited)
+         *
+         * Applied by the registry before write()/write_block(), so a sink with
+         * a small payload limit (syslog, UDP) gets a marked, shortened line
+         * while other sinks still receive the full record.
+         */
+        void set_max_record_size(size_t bytes) noexcept { max_record_size_ = bytes; }
+
+        /**
+         * @brief Get the record size cap (0 = unlimited)
+         */
+        [[nodiscard]] size_t max_record_size() const noexcept { return max_record_size_; }
+
         /**
          * @brief Set custom formatter for this sink
          * @param formatter Shared pointer to formatter
@@ -99,8 +198,44 @@ namespace echo {
         [[nodiscard]] virtual FormatterPtr get_formatter() const { return formatter_; }
 
       protected:
+        /**
+         * @brief Collect the lines of a block that pass should_log()
+         * @param block Block to filter
+         * @param scratch Storage used when only some lines pass
+         * @param level Set to the highest level among the passing lines
+         * @return The text to write, or nullptr if no line passes
+         */
+        const std::string *select_block_lines(const LogBlock &block, std::string &scratch, Level &level) const {
+            bool any = false, all = true;
+            for (const auto &line : block.lines) {
+                if (!should_log(line.level)) {
+                    all = false;
+                    continue;
+                }
+                if (!any || static_cast<int>(line.level) > static_cast<int>(level)) {
+                    level = line.level;
+                }
+                any = true;
+            }
+            if (!any) {
+                return nullptr;
+            }
+            if (all) {
+                return &block.text;
+            }
+
+            scratch.clear();
+            for (const auto &line : block.lines) {
+                if (should_log(line.level)) {
+                    scratch.append(block.text, line.begin, line.end - line.begin);
+                }
+            }
+            return &scratch;
+        }
+
         Level min_level_ = Level::Trace;   ///< Minimum level to log (default: log everything)
         FormatterPtr formatter_ = nullptr; ///< Custom formatter (nullptr = use default)
+        size_t max_record_size_ = 0;       ///< Record size cap in bytes (0 = unlimited)
     };
 
     /// Shared pointer to a sink (for easy management)
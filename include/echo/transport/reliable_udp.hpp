@@ -0,0 +1,561 @@
+#pragma once
+
+/**
+ * @file transport/reliable_udp.hpp
+ * @brief Wire format and receiver for the reliable UDP log transport
+ *
+ * Records are sent in batched UDP datagrams that carry a per-process stream id
+ * and a sequence number. The receiver reorders and deduplicates datagrams,
+ * asks the sender to retransmit missing ones (NACK), and reports gaps it could
+ * not recover. See ReliableUdpSink for the sending side.
+ *
+ * Wire format (all integers big-endian):
+ *
+ *   DATA       magic:u32 type:u8=1 flags:u8 count:u16 stream:u64 seq:u64
+ *              count x { level:u8 length:u32 bytes[length] }
+ *   NACK       magic:u32 type:u8=2 flags:u8 count:u16 stream:u64 0:u64
+ *              count x { first:u64 last:u64 }          (inclusive ranges)
+ *   HEARTBEAT  magic:u32 type:u8=3 flags:u8 0:u16     stream:u64 last_seq:u64
+ *
+ * Only available on Unix/Linux.
+ */
+
+#include <echo/core/level.hpp>
+
+#ifdef __unix__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#endif
+
+namespace echo {
+
+#ifdef __unix__
+
+    namespace detail {
+
+        // =================================================================================================
+        // Reliable UDP wire format
+        // =================================================================================================
+
+        constexpr uint32_t RUDP_MAGIC = 0x45434855; // "ECHU"
+        constexpr uint8_t RUDP_DATA = 1;
+        constexpr uint8_t RUDP_NACK = 2;
+        constexpr uint8_t RUDP_HEARTBEAT = 3;
+        constexpr size_t RUDP_HEADER_SIZE = 24;
+        constexpr size_t RUDP_RECORD_OVERHEAD = 5;
+        constexpr size_t RUDP_MAX_DATAGRAM = 65507;
+        constexpr size_t RUDP_MAX_NACK_RANGES = (1400 - RUDP_HEADER_SIZE) / 16;
+        constexpr int RUDP_HEARTBEAT_REPEATS = 3; // Idle heartbeats per tail seq (covers a lost heartbeat)
+
+        inline void rudp_put_u16(std::string &out, uint16_t v) {
+            out += static_cast<char>(v >> 8);
+            out += static_cast<char>(v);
+        }
+
+        inline void rudp_put_u32(std::string &out, uint32_t v) {
+            rudp_put_u16(out, static_cast<uint16_t>(v >> 16));
+            rudp_put_u16(out, static_cast<uint16_t>(v));
+        }
+
+        inline void rudp_put_u64(std::string &out, uint64_t v) {
+            rudp_put_u32(out, static_cast<uint32_t>(v >> 32));
+            rudp_put_u32(out, static_cast<uint32_t>(v));
+        }
+
+        inline uint16_t rudp_get_u16(const unsigned char *p) { return static_cast<uint16_t>((p[0] << 8) | p[1]); }
+
+        inline uint32_t rudp_get_u32(const unsigned char *p) {
+            return (static_cast<uint32_t>(rudp_get_u16(p)) << 16) | rudp_get_u16(p + 2);
+        }
+
+        inline uint64_t rudp_get_u64(const unsigned char *p) {
+            return (static_cast<uint64_t>(rudp_get_u32(p)) << 32) | rudp_get_u32(p + 4);
+        }
+
+        /**
+         * @brief Append a datagram header
+         */
+        inline void rudp_put_header(std::string &out, uint8_t type, uint16_t count, uint64_t stream, uint64_t seq) {
+            rudp_put_u32(out, RUDP_MAGIC);
+            out += static_cast<char>(type);
+            out += '\0'; // flags (reserved)
+            rudp_put_u16(out, count);
+            rudp_put_u64(out, stream);
+            rudp_put_u64(out, seq);
+        }
+
+        /**
+         * @brief Parsed datagram header
+         */
+        struct RudpHeader {
+            uint8_t type = 0;
+            uint16_t count = 0;
+            uint64_t stream = 0;
+            uint64_t seq = 0;
+        };
+
+        /**
+         * @brief Parse a datagram header
+         * @return false if the datagram is too short or not ours
+         */
+        inline bool rudp_parse_header(const unsigned char *data, size_t size, RudpHeader &header) {
+            if (size < RUDP_HEADER_SIZE || rudp_get_u32(data) != RUDP_MAGIC) {
+                return false;
+            }
+            header.type = data[4];
+            header.count = rudp_get_u16(data + 6);
+            header.stream = rudp_get_u64(data + 8);
+            header.seq = rudp_get_u64(data + 16);
+            return true;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief A record delivered by ReliableUdpReceiver
+     *
+     * The message view is only valid during the record callback.
+     */
+    struct ReceivedRecord {
+        uint64_t stream_id;       ///< Sender's per-process stream id
+        uint64_t seq;             ///< Sequence number of the carrying datagram
+        Level level;              ///< Log level
+        std::string_view message; ///< Record text (ANSI codes stripped by the sender)
+    };
+
+    /**
+     * @brief Receiver counters
+     */
+    struct ReliableUdpReceiverStats {
+        uint64_t datagrams = 0;    ///< Valid DATA datagrams received
+        uint64_t records = 0;      ///< Records delivered in order
+        uint64_t duplicates = 0;   ///< Datagrams dropped as already seen
+        uint64_t out_of_order = 0; ///< Datagrams that arrived ahead of a gap
+        uint64_t nacks_sent = 0;   ///< NACK datagrams sent
+        uint64_t recovered = 0;    ///< Missing datagrams that arrived after a NACK
+        uint64_t lost = 0;         ///< Datagrams given up on
+        uint64_t malformed = 0;    ///< Records dropped for a level byte outside Trace..Critical
+    };
+
+    /**
+     * @brief Receiver for ReliableUdpSink streams
+     *
+     * Delivers records in sequence order per stream through the record callback,
+     * deduplicates, NACKs missing datagrams, and reports unrecoverable gaps
+     * through the gap callback after max_nack_attempts.
+     *
+     * Not thread-safe: drive it from one thread by calling poll().
+     *
+     * Example:
+     *   echo::ReliableUdpReceiver receiver(5141, "0.0.0.0");
+     *   receiver.on_record([](const echo::ReceivedRecord &r) { store(r.message); });
+     *   receiver.on_gap([](uint64_t stream, uint64_t first, uint64_t last) { alert(first, last); });
+     *   while (running) receiver.poll(std::chrono::milliseconds(100));
+     */
+    class ReliableUdpReceiver {
+      public:
+        using RecordCallback = std::function<void(const ReceivedRecord &)>;
+        using GapCallback = std::function<void(uint64_t stream_id, uint64_t first_seq, uint64_t last_seq)>;
+
+      private:
+        using clock = std::chrono::steady_clock;
+
+        struct Missing {
+            int attempts = 0;
+            clock::time_point last_nack{};
+        };
+
+        struct Stream {
+            sockaddr_storage addr{};
+            socklen_t addr_len = 0;
+            uint64_t expected = 1;     // next seq to deliver
+            uint64_t highest_seen = 0; // highest seq known to exist
+            std::map<uint64_t, std::string> pending;
+            std::map<uint64_t, Missing> missing;
+        };
+
+        int socket_ = -1;
+        uint16_t port_ = 0;
+        std::unordered_map<uint64_t, Stream> streams_;
+        RecordCallback on_record_;
+        GapCallback on_gap_;
+        std::chrono::milliseconds nack_interval_{20};
+        int max_nack_attempts_ = 5;
+        size_t max_pending_ = 4096;
+        std::vector<unsigned char> recv_buffer_ = std::vector<unsigned char>(detail::RUDP_MAX_DATAGRAM);
+        std::string nack_buffer_;
+        ReliableUdpReceiverStats stats_;
+
+        size_t deliver(uint64_t stream_id, uint64_t seq, const unsigned char *data, size_t size, uint16_t count) {
+            size_t delivered = 0;
+            size_t pos = 0;
+            for (uint16_t i = 0; i < count && pos + detail::RUDP_RECORD_OVERHEAD <= size; ++i) {
+                unsigned char level_byte = data[pos];
+                uint32_t len = detail::rudp_get_u32(data + pos + 1);
+                pos += detail::RUDP_RECORD_OVERHEAD;
+                if (pos + len > size) {
+                    break;
+                }
+                // Consumers index tables by level: never pass on a value no sender produces
+                if (level_byte > static_cast<unsigned char>(Level::Critical)) {
+                    ++stats_.malformed;
+                    pos += len;
+                    continue;
+                }
+                Level level = static_cast<Level>(level_byte);
+                if (on_record_) {
+                    on_record_(ReceivedRecord{stream_id, seq, level,
+                                              std::string_view(reinterpret_cast<const char *>(data + pos), len)});
+                }
+                pos += len;
+                ++delivered;
+            }
+            stats_.records += delivered;
+            return delivered;
+        }
+
+        size_t deliver_payload(uint64_t stream_id, uint64_t seq, const std::string &datagram) {
+            const auto *data = reinterpret_cast<const unsigned char *>(datagram.data());
+            detail::RudpHeader header;
+            detail::rudp_parse_header(data, datagram.size(), header);
+            return deliver(stream_id, seq, data + detail::RUDP_HEADER_SIZE, datagram.size() - detail::RUDP_HEADER_SIZE,
+                           header.count);
+        }
+
+        /**
+         * @brief Deliver everything that is now in order, skipping abandoned seqs
+         *
+         * A seq below highest_seen that is neither pending nor missing was given up on.
+         */
+        size_t advance(uint64_t stream_id, Stream &stream) {
+            size_t delivered = 0;
+            while (stream.expected <= stream.highest_seen) {
+                auto it = stream.pending.find(stream.expected);
+                if (it != stream.pending.end()) {
+                    delivered += deliver_payload(stream_id, it->first, it->second);
+                    stream.pending.erase(it);
+                    ++stream.expected;
+                    continue;
+                }
+                if (stream.missing.count(stream.expected)) {
+                    break;
+                }
+                // Abandoned: jump to the next seq we either hold or still wait for
+                uint64_t next = stream.highest_seen + 1;
+                auto p = stream.pending.lower_bound(stream.expected);
+                if (p != stream.pending.end() && p->first < next) {
+                    next = p->first;
+                }
+                auto m = stream.missing.lower_bound(stream.expected);
+                if (m != stream.missing.end() && m->first < next) {
+                    next = m->first;
+                }
+                stream.expected = next;
+            }
+            return delivered;
+        }
+
+        void report_gap(uint64_t stream_id, uint64_t first, uint64_t last) {
+            stats_.lost += last - first + 1;
+            if (on_gap_) {
+                on_gap_(stream_id, first, last);
+            }
+        }
+
+        /**
+         * @brief Give up on missing seqs matching a predicate, reporting them as ranges
+         */
+        template <typename Pred> void abandon(uint64_t stream_id, Stream &stream, Pred pred) {
+            bool open = false;
+            uint64_t first = 0, last = 0;
+            for (auto it = stream.missing.begin(); it != stream.missing.end();) {
+                if (!pred(it->first, it->second)) {
+                    ++it;
+                    continue;
+                }
+                if (open && it->first == last + 1) {
+                    last = it->first;
+                } else {
+                    if (open) {
+                        report_gap(stream_id, first, last);
+                    }
+                    first = last = it->first;
+                    open = true;
+                }
+                it = stream.missing.erase(it);
+            }
+            if (open) {
+                report_gap(stream_id, first, last);
+            }
+        }
+
+        /**
+         * @brief NACK every missing seq whose retry is due
+         */
+        void send_nacks(uint64_t stream_id, Stream &stream, clock::time_point now) {
+            nack_buffer_.clear();
+            uint16_t ranges = 0;
+            bool open = false;
+            uint64_t first = 0, last = 0;
+
+            auto emit_range = [&] {
+                detail::rudp_put_u64(nack_buffer_, first);
+                detail::rudp_put_u64(nack_buffer_, last);
+                ++ranges;
+            };
+
+            for (auto &[seq, info] : stream.missing) {
+                if (info.attempts > 0 && now - info.last_nack < nack_interval_) {
+                    continue;
+                }
+                if (info.attempts >= max_nack_attempts_) {
+                    continue;
+                }
+                if (open && seq == last + 1) {
+                    last = seq;
+                } else {
+                    if (open) {
+                        emit_range();
+                        open = false;
+                        // A seq that cannot be NACKed now keeps its attempt for the next round
+                        if (ranges == detail::RUDP_MAX_NACK_RANGES) {
+                            break;
+                        }
+                    }
+                    first = last = seq;
+                    open = true;
+                }
+                ++info.attempts;
+                info.last_nack = now;
+            }
+            if (open) {
+                emit_range();
+            }
+            if (ranges == 0) {
+                return;
+            }
+
+            std::string datagram;
+            datagram.reserve(detail::RUDP_HEADER_SIZE + nack_buffer_.size());
+            detail::rudp_put_header(datagram, detail::RUDP_NACK, ranges, stream_id, 0);
+            datagram += nack_buffer_;
+            ::sendto(socket_, datagram.data(), datagram.size(), MSG_DONTWAIT,
+                     reinterpret_cast<const sockaddr *>(&stream.addr), stream.addr_len);
+            ++stats_.nacks_sent;
+        }
+
+        /**
+         * @brief Record that seqs up to `seq` exist, adding any unseen ones as missing
+         */
+        void note_highest(uint64_t stream_id, Stream &stream, uint64_t seq) {
+            if (seq <= stream.highest_seen) {
+                return;
+            }
+            if (seq - stream.highest_seen > max_pending_) {
+                // Too far ahead to track individually: treat the hole as lost
+                abandon(stream_id, stream, [](uint64_t, const Missing &) { return true; });
+                report_gap(stream_id, stream.highest_seen + 1, seq - 1);
+                stream.highest_seen = seq;
+                return;
+            }
+            for (uint64_t s = stream.highest_seen + 1; s <= seq; ++s) {
+                stream.missing.emplace(s, Missing{});
+            }
+            stream.highest_seen = seq;
+        }
+
+        size_t handle_datagram(const unsigned char *data, size_t size, const sockaddr_storage &from,
+                               socklen_t from_len) {
+            detail::RudpHeader header;
+            if (!detail::rudp_parse_header(data, size, header)) {
+                return 0;
+            }
+            if (header.type != detail::RUDP_DATA && header.type != detail::RUDP_HEARTBEAT) {
+                return 0;
+            }
+
+            auto [it, inserted] = streams_.try_emplace(header.stream);
+            Stream &stream = it->second;
+            stream.addr = from;
+            stream.addr_len = from_len;
+            if (inserted) {
+                // A receiver that starts late does not try to recover the sender's whole history
+                stream.expected = (header.seq <= max_pending_) ? 1 : header.seq;
+                stream.highest_seen = stream.expected - 1;
+            }
+
+            if (header.type == detail::RUDP_HEARTBEAT) {
+                note_highest(header.stream, stream, header.seq);
+                return advance(header.stream, stream);
+            }
+
+            ++stats_.datagrams;
+            uint64_t seq = header.seq;
+            if (seq < stream.expected || stream.pending.count(seq)) {
+                ++stats_.duplicates;
+                return 0;
+            }
+
+            auto missing = stream.missing.find(seq);
+            if (missing != stream.missing.end()) {
+                if (missing->second.attempts > 0) {
+                    ++stats_.recovered;
+                }
+                stream.missing.erase(missing);
+            }
+            note_highest(header.stream, stream, seq);
+            stream.missing.erase(seq);
+
+            if (seq != stream.expected) {
+                ++stats_.out_of_order;
+            }
+            stream.pending.emplace(seq, std::string(reinterpret_cast<const char *>(data), size));
+
+            if (stream.pending.size() > max_pending_) {
+                uint64_t oldest = stream.pending.begin()->first;
+                abandon(header.stream, stream, [oldest](uint64_t s, const Missing &) { return s < oldest; });
+            }
+
+            return advance(header.stream, stream);
+        }
+
+        size_t run_timers() {
+            size_t delivered = 0;
+            auto now = clock::now();
+            for (auto &[id, stream] : streams_) {
+                if (stream.missing.empty()) {
+                    continue;
+                }
+                const int max_attempts = max_nack_attempts_;
+                const auto interval = nack_interval_;
+                abandon(id, stream, [&](uint64_t, const Missing &m) {
+                    return m.attempts >= max_attempts && now - m.last_nack >= interval;
+                });
+                send_nacks(id, stream, now);
+                delivered += advance(id, stream);
+            }
+            return delivered;
+        }
+
+      public:
+        /**
+         * @brief Bind a receiver
+         * @param port UDP port (0 picks an ephemeral port, see port())
+         * @param bind_address IPv4 address to bind
+         */
+        explicit ReliableUdpReceiver(uint16_t port = 0, const std::string &bind_address = "127.0.0.1") {
+            socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+            if (socket_ == -1) {
+                return;
+            }
+
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(port);
+            if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1 ||
+                ::bind(socket_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+                ::close(socket_);
+                socket_ = -1;
+                return;
+            }
+
+            socklen_t len = sizeof(addr);
+            ::getsockname(socket_, reinterpret_cast<sockaddr *>(&addr), &len);
+            port_ = ntohs(addr.sin_port);
+        }
+
+        ~ReliableUdpReceiver() {
+            if (socket_ != -1) {
+                ::close(socket_);
+            }
+        }
+
+        ReliableUdpReceiver(const ReliableUdpReceiver &) = delete;
+        ReliableUdpReceiver &operator=(const ReliableUdpReceiver &) = delete;
+
+        /**
+         * @brief Wait for datagrams, process them, and run NACK/gap timers
+         * @param timeout Maximum time to wait for the first datagram
+         * @return Number of records delivered
+         */
+        size_t poll(std::chrono::milliseconds timeout = std::chrono::milliseconds(0)) {
+            if (socket_ == -1) {
+                return 0;
+            }
+
+            size_t delivered = 0;
+            pollfd pfd{socket_, POLLIN, 0};
+            if (::poll(&pfd, 1, static_cast<int>(timeout.count())) > 0) {
+                while (true) {
+                    sockaddr_storage from{};
+                    socklen_t from_len = sizeof(from);
+                    ssize_t n = ::recvfrom(socket_, recv_buffer_.data(), recv_buffer_.size(), MSG_DONTWAIT,
+                                           reinterpret_cast<sockaddr *>(&from), &from_len);
+                    if (n <= 0) {
+                        break;
+                    }
+                    delivered += handle_datagram(recv_buffer_.data(), static_cast<size_t>(n), from, from_len);
+                }
+            }
+
+            delivered += run_timers();
+            return delivered;
+        }
+
+        /**
+         * @brief Set the callback receiving in-order records
+         */
+        void on_record(RecordCallback callback) { on_record_ = std::move(callback); }
+
+        /**
+         * @brief Set the callback receiving unrecoverable gaps (inclusive seq range)
+         */
+        void on_gap(GapCallback callback) { on_gap_ = std::move(callback); }
+
+        /**
+         * @brief Set time between NACKs for the same missing datagram
+         */
+        void set_nack_interval(std::chrono::milliseconds interval) { nack_interval_ = interval; }
+
+        /**
+         * @brief Set NACKs sent per missing datagram before it is reported lost
+         */
+        void set_max_nack_attempts(int attempts) { max_nack_attempts_ = attempts; }
+
+        /**
+         * @brief Set how many out-of-order datagrams are held per stream
+         */
+        void set_max_pending(size_t datagrams) { max_pending_ = datagrams; }
+
+        /**
+         * @brief Check whether the socket is bound
+         */
+        [[nodiscard]] bool is_open() const { return socket_ != -1; }
+
+        /**
+         * @brief Get the bound port
+         */
+        [[nodiscard]] uint16_t port() const { return port_; }
+
+        /**
+         * @brief Get counters
+         */
+        [[nodiscard]] const ReliableUdpReceiverStats &stats() const { return stats_; }
+    };
+
+#endif // __unix__
+
+} // namespace echo
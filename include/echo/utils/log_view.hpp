@@ -0,0 +1,785 @@
+#pragma once
+
+/**
+ * @file utils/log_view.hpp
+ * @brief Memory-mapped log reading: line index, echo line parsing, SIMD search
+ *
+ * Engine of the echo-view tool (tools/echo-view.cpp), usable on its own.
+ * LogView maps one or more files read-only (e.g. a rotation set, oldest
+ * first) and treats them as one sequence of lines addressed by byte offset.
+ * Nothing is copied into memory; the page cache holds what was touched.
+ *
+ * - A background thread builds a sparse line index (one checkpoint every
+ *   LINES_PER_CHECKPOINT lines, ~8 bytes per 1024 lines), so line numbers
+ *   become available progressively while the file is already browsable.
+ * - parse_line() recognizes echo's line formats ("[time][level] [category] msg",
+ *   with or without timestamp, ANSI colors or category tag) for filtering by
+ *   level and category.
+ * - find() searches the mapping with an AVX2 substring kernel (first/last byte
+ *   filter, then verify), falling back to a scalar search without AVX2;
+ *   find_some() does the same in bounded steps that can be resumed.
+ *
+ * Only available on Unix/Linux. Not included by echo.hpp.
+ *
+ * Example:
+ *   echo::LogView view;
+ *   view.open(echo::rotation_set("app.log"));
+ *   view.start_indexing();
+ *   echo::ViewFilter filter;
+ *   filter.min_level = echo::Level::Warn;
+ *   auto hit = view.find("timeout", 0, true, &filter);
+ *   if (hit) std::cout << view.line(*hit) << "\n";
+ */
+
+#include <echo/core/level.hpp>
+#include <echo/filters/category.hpp>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <dirent.h>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) && !defined(ECHO_SIMD_DISABLED)
+#define ECHO_VIEW_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+namespace echo {
+
+#ifdef __unix__
+
+    namespace detail {
+
+        // =================================================================================================
+        // SIMD kernels
+        // =================================================================================================
+
+        /**
+         * @brief Find needle in [begin, end); returns end if absent
+         *
+         * AVX2: compare 32 positions at once against the needle's first and
+         * last byte, and verify only the candidates where both match.
+         */
+        inline const char *find_substring(const char *begin, const char *end, std::string_view needle) {
+            const size_t n = needle.size();
+            const size_t len = static_cast<size_t>(end - begin);
+            if (n == 0) {
+                return begin;
+            }
+            if (n > len) {
+                return end;
+            }
+            if (n == 1) {
+                const void *hit = std::memchr(begin, needle[0], len);
+                return hit ? static_cast<const char *>(hit) : end;
+            }
+
+            size_t i = 0;
+#ifdef ECHO_VIEW_AVX2
+            const __m256i first = _mm256_set1_epi8(needle[0]);
+            const __m256i last = _mm256_set1_epi8(needle[n - 1]);
+            for (; i + n - 1 + 32 <= len; i += 32) {
+                __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin + i));
+                __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin + i + n - 1));
+                auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+                    _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+                while (mask != 0) {
+                    unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+                    if (std::memcmp(begin + i + bit + 1, needle.data() + 1, n - 2) == 0) {
+                        return begin + i + bit;
+                    }
+                    mask &= mask - 1;
+                }
+            }
+#endif
+            size_t pos = std::string_view(begin + i, len - i).find(needle);
+            return pos == std::string_view::npos ? end : begin + i + pos;
+        }
+
+        /**
+         * @brief Count '\n' bytes in [begin, end)
+         */
+        inline uint64_t count_newlines(const char *begin, const char *end) {
+            uint64_t count = 0;
+            const char *p = begin;
+#ifdef ECHO_VIEW_AVX2
+            const __m256i nl = _mm256_set1_epi8('\n');
+            for (; p + 32 <= end; p += 32) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                count += static_cast<uint64_t>(
+                    __builtin_popcount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, nl)))));
+            }
+#endif
+            return count + static_cast<uint64_t>(std::count(p, end, '\n'));
+        }
+
+        /**
+         * @brief Report the offset (relative to begin) after every newline whose line number hits a multiple of step
+         *
+         * lines is the running count of line starts before begin; it is updated.
+         */
+        template <typename Callback>
+        inline void scan_line_starts(const char *begin, const char *end, uint64_t &lines, uint64_t step,
+                                     Callback &&on_checkpoint) {
+            const char *p = begin;
+            uint64_t next = (lines / step + 1) * step;
+#ifdef ECHO_VIEW_AVX2
+            const __m256i nl = _mm256_set1_epi8('\n');
+            for (; p + 32 <= end; p += 32) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, nl)));
+                auto count = static_cast<uint64_t>(__builtin_popcount(mask));
+                if (lines + count < next) {
+                    lines += count; // Common case: no checkpoint in this block
+                    continue;
+                }
+                while (mask != 0) {
+                    unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+                    if (++lines == next) {
+                        on_checkpoint(static_cast<uint64_t>(p - begin) + bit + 1);
+                        next += step;
+                    }
+                    mask &= mask - 1;
+                }
+            }
+#endif
+            for (; p < end; ++p) {
+                if (*p == '\n' && ++lines == next) {
+                    on_checkpoint(static_cast<uint64_t>(p - begin) + 1);
+                    next += step;
+                }
+            }
+        }
+
+    } // namespace detail
+
+    // =================================================================================================
+    // Line parsing and filtering
+    // =================================================================================================
+
+    /**
+     * @brief What parse_line() recognized in an echo log line
+     */
+    struct LineInfo {
+        bool has_level = false;    ///< A "[level]" field was found
+        Level level = Level::Info; ///< Parsed level (valid if has_level)
+        std::string_view category; ///< "[category]" right after the level field, if any
+        std::string_view message;  ///< Text after the recognized prefix
+    };
+
+    /**
+     * @brief Parse the prefix of an echo line
+     *
+     * Accepts "[12:00:00][info] msg", "[info] msg", "[12:00:00.123][warning] [net] msg"
+     * (BatchRenderer, StdioCapture and metrics tags) and the same with ANSI colors.
+     */
+    inline LineInfo parse_line(std::string_view line) {
+        LineInfo info;
+        size_t pos = 0;
+        auto skip_ansi = [&] {
+            while (pos + 1 < line.size() && line[pos] == '\033' && line[pos + 1] == '[') {
+                size_t m = line.find('m', pos + 2);
+                if (m == std::string_view::npos) {
+                    return;
+                }
+                pos = m + 1;
+            }
+        };
+        auto bracket = [&](std::string_view &field) {
+            skip_ansi();
+            if (pos >= line.size() || line[pos] != '[') {
+                return false;
+            }
+            size_t close = line.find(']', pos + 1);
+            if (close == std::string_view::npos || close - pos > 64) {
+                return false;
+            }
+            field = line.substr(pos + 1, close - pos - 1);
+            pos = close + 1;
+            skip_ansi();
+            return true;
+        };
+
+        std::string_view field;
+        // Up to two leading fields: optional timestamp, then the level
+        for (int i = 0; i < 2 && bracket(field); ++i) {
+            std::optional<Level> level;
+            if (field == "warn") {
+                level = Level::Warn;
+            } else {
+                for (int l = 0; l <= static_cast<int>(Level::Critical); ++l) {
+                    if (field == detail::level_name(static_cast<Level>(l))) {
+                        level = static_cast<Level>(l);
+                    }
+                }
+            }
+            if (level) {
+                info.has_level = true;
+                info.level = *level;
+                break;
+            }
+        }
+        if (!info.has_level) {
+            info.message = line;
+            return info;
+        }
+
+        if (pos < line.size() && line[pos] == ' ') {
+            ++pos;
+        }
+        size_t before_category = pos;
+        if (bracket(field) && !field.empty() && field.find(' ') == std::string_view::npos) {
+            info.category = field;
+            if (pos < line.size() && line[pos] == ' ') {
+                ++pos;
+            }
+        } else {
+            pos = before_category;
+        }
+        info.message = line.substr(pos);
+        return info;
+    }
+
+    /**
+     * @brief Which lines a view shows
+     */
+    struct ViewFilter {
+        Level min_level = Level::Trace; ///< Hide leveled lines below this
+        std::string category;           ///< Category or pattern ("net", "app.*"); empty = any
+        bool keep_unparsed = true;      ///< Show lines without a level (continuations, foreign output)
+
+        [[nodiscard]] bool active() const { return min_level != Level::Trace || !category.empty(); }
+
+        [[nodiscard]] bool matches(std::string_view line) const {
+            if (!active()) {
+                return true;
+            }
+            LineInfo info = parse_line(line);
+            if (!info.has_level) {
+                return keep_unparsed && category.empty();
+            }
+            if (static_cast<int>(info.level) < static_cast<int>(min_level)) {
+                return false;
+            }
+            if (!category.empty()) {
+                return detail::CategoryRegistry::matches_pattern(category, info.category);
+            }
+            return true;
+        }
+    };
+
+    namespace detail {
+        inline bool all_digits(std::string_view s) {
+            return !s.empty() && std::all_of(s.begin(), s.end(), [](char c) { return c >= '0' && c <= '9'; });
+        }
+
+        /**
+         * @brief Check a name's text after "<base>." against FileSink's rotation names
+         *
+         * Accepts "N" and "YYYYMMDD_HHMMSS.N"; compressed copies, lock files and
+         * backups ("gz", "2.gz", "lock", "bak") are not part of the rotation.
+         */
+        inline bool is_rotation_suffix(std::string_view suffix) {
+            if (all_digits(suffix)) {
+                return true;
+            }
+            size_t dot = suffix.find('.');
+            if (dot != 15 || suffix[8] != '_') {
+                return false;
+            }
+            return all_digits(suffix.substr(0, 8)) && all_digits(suffix.substr(9, 6)) &&
+                   all_digits(suffix.substr(dot + 1));
+        }
+    } // namespace detail
+
+    /**
+     * @brief Rotated files of a log, oldest first, the live file last
+     *
+     * Collects the siblings FileSink produces ("app.log.2", "app.log.<time>.1")
+     * and orders them by modification time.
+     */
+    inline std::vector<std::string> rotation_set(const std::string &path) {
+        size_t slash = path.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : path.substr(0, slash == 0 ? 1 : slash);
+        std::string base = slash == std::string::npos ? path : path.substr(slash + 1);
+
+        std::vector<std::pair<int64_t, std::string>> rotated;
+        if (DIR *d = ::opendir(dir.c_str())) {
+            while (dirent *entry = ::readdir(d)) {
+                std::string name = entry->d_name;
+                if (name.size() > base.size() + 1 && name.compare(0, base.size() + 1, base + ".") == 0 &&
+                    detail::is_rotation_suffix(std::string_view(name).substr(base.size() + 1))) {
+                    std::string full = slash == std::string::npos ? name : dir + "/" + name;
+                    struct stat st;
+                    if (::stat(full.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+                        int64_t mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+                        rotated.emplace_back(mtime, full);
+                    }
+                }
+            }
+            ::closedir(d);
+        }
+        std::sort(rotated.begin(), rotated.end());
+
+        std::vector<std::string> result;
+        for (auto &[mtime, name] : rotated) {
+            result.push_back(std::move(name));
+        }
+        result.push_back(path);
+        return result;
+    }
+
+    // =================================================================================================
+    // LogView
+    // =================================================================================================
+
+    /**
+     * @brief Read-only view of mapped log files as one sequence of lines
+     *
+     * Lines are addressed by the byte offset of their first character in the
+     * concatenation of all files; a line never spans two files. Navigation
+     * works immediately; line numbers are available once the background
+     * index has passed the position.
+     */
+    class LogView {
+      public:
+        static constexpr uint64_t LINES_PER_CHECKPOINT = 1024; ///< Index density
+        static constexpr uint64_t INDEX_CHUNK = 8 << 20;       ///< Bytes indexed between progress updates
+
+        /**
+         * @brief One mapped file
+         */
+        struct Segment {
+            std::string path;
+            const char *data = nullptr;
+            uint64_t size = 0;
+            uint64_t base = 0; ///< Offset of the first byte in the view
+        };
+
+      private:
+        std::vector<Segment> segments_;
+        uint64_t total_size_ = 0;
+        std::string error_;
+
+        mutable std::mutex index_mutex_;
+        std::vector<uint64_t> checkpoints_; // Offset of line k * LINES_PER_CHECKPOINT
+        std::atomic<uint64_t> indexed_bytes_{0};
+        std::atomic<uint64_t> indexed_lines_{0};
+        std::atomic<bool> index_done_{false};
+        std::atomic<bool> stop_{false};
+        std::thread indexer_;
+
+        const Segment *segment_at(uint64_t offset) const {
+            auto it = std::upper_bound(segments_.begin(), segments_.end(), offset,
+                                       [](uint64_t off, const Segment &s) { return off < s.base; });
+            if (it == segments_.begin()) {
+                return nullptr;
+            }
+            --it;
+            return offset < it->base + it->size ? &*it : nullptr;
+        }
+
+        void build_index() {
+            uint64_t lines = 0;
+            for (size_t s = 0; s < segments_.size() && !stop_; ++s) {
+                const Segment &seg = segments_[s];
+                for (uint64_t off = 0; off < seg.size && !stop_; off += INDEX_CHUNK) {
+                    uint64_t len = std::min<uint64_t>(INDEX_CHUNK, seg.size - off);
+                    std::vector<uint64_t> found;
+                    detail::scan_line_starts(seg.data + off, seg.data + off + len, lines, LINES_PER_CHECKPOINT,
+                                             [&](uint64_t rel) { found.push_back(seg.base + off + rel); });
+
+                    bool last_chunk = off + len == seg.size;
+                    if (last_chunk && seg.data[seg.size - 1] != '\n') {
+                        // Unterminated last line: the file end terminates it
+                        if (++lines % LINES_PER_CHECKPOINT == 0) {
+                            found.push_back(seg.base + seg.size);
+                        }
+                    }
+                    if (last_chunk && !found.empty() && found.back() == seg.base + seg.size) {
+                        // A line "starting" at the file end starts in the next file, if any
+                        if (s + 1 == segments_.size()) {
+                            found.pop_back();
+                        }
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(index_mutex_);
+                        checkpoints_.insert(checkpoints_.end(), found.begin(), found.end());
+                    }
+                    indexed_lines_.store(lines, std::memory_order_release);
+                    indexed_bytes_.store(seg.base + off + len, std::memory_order_release);
+                }
+            }
+            index_done_.store(!stop_, std::memory_order_release);
+        }
+
+        /// Line terminators ('\n', or a file end without one) in [from, to)
+        uint64_t count_line_ends(uint64_t from, uint64_t to) const {
+            uint64_t count = 0;
+            for (const Segment &seg : segments_) {
+                uint64_t seg_end = seg.base + seg.size;
+                if (seg_end <= from || seg.base >= to) {
+                    continue;
+                }
+                uint64_t a = std::max(from, seg.base);
+                uint64_t b = std::min(to, seg_end);
+                count += detail::count_newlines(seg.data + (a - seg.base), seg.data + (b - seg.base));
+                if (b == seg_end && seg.data[seg.size - 1] != '\n') {
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+      public:
+        LogView() = default;
+        ~LogView() { close(); }
+
+        LogView(const LogView &) = delete;
+        LogView &operator=(const LogView &) = delete;
+
+        /**
+         * @brief Map files in order (empty files are skipped)
+         * @return false if a file could not be opened or mapped; see error()
+         */
+        bool open(const std::vector<std::string> &paths) {
+            close();
+            for (const auto &path : paths) {
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) {
+                    error_ = "cannot open " + path + ": " + std::strerror(errno);
+                    close();
+                    return false;
+                }
+                struct stat st;
+                if (::fstat(fd, &st) != 0) {
+                    error_ = "cannot stat " + path;
+                    ::close(fd);
+                    close();
+                    return false;
+                }
+                if (st.st_size == 0) {
+                    ::close(fd);
+                    continue;
+                }
+                void *map = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (map == MAP_FAILED) {
+                    error_ = "cannot map " + path + ": " + std::strerror(errno);
+                    close();
+                    return false;
+                }
+                segments_.push_back({path, static_cast<const char *>(map), static_cast<uint64_t>(st.st_size),
+                                     total_size_});
+                total_size_ += static_cast<uint64_t>(st.st_size);
+            }
+            checkpoints_.push_back(0);
+            return true;
+        }
+
+        /**
+         * @brief Stop indexing and unmap everything
+         */
+        void close() {
+            stop_ = true;
+            if (indexer_.joinable()) {
+                indexer_.join();
+            }
+            for (const Segment &seg : segments_) {
+                ::munmap(const_cast<char *>(seg.data), static_cast<size_t>(seg.size));
+            }
+            segments_.clear();
+            checkpoints_.clear();
+            total_size_ = 0;
+            indexed_bytes_ = 0;
+            indexed_lines_ = 0;
+            index_done_ = false;
+            stop_ = false;
+        }
+
+        /**
+         * @brief Build the line index on a background thread
+         */
+        void start_indexing() {
+            if (!indexer_.joinable() && !index_done_) {
+                indexer_ = std::thread([this] { build_index(); });
+            }
+        }
+
+        /**
+         * @brief Block until the index is complete
+         */
+        void wait_for_index() {
+            start_indexing();
+            if (indexer_.joinable()) {
+                indexer_.join();
+            }
+        }
+
+        [[nodiscard]] const std::string &error() const { return error_; }
+        [[nodiscard]] const std::vector<Segment> &segments() const { return segments_; }
+        [[nodiscard]] uint64_t size() const { return total_size_; }
+        [[nodiscard]] bool empty() const { return total_size_ == 0; }
+
+        [[nodiscard]] uint64_t indexed_bytes() const { return indexed_bytes_.load(std::memory_order_acquire); }
+        [[nodiscard]] uint64_t indexed_lines() const { return indexed_lines_.load(std::memory_order_acquire); }
+        [[nodiscard]] bool index_complete() const { return index_done_.load(std::memory_order_acquire); }
+
+        /**
+         * @brief File containing an offset ("" past the end)
+         */
+        [[nodiscard]] std::string_view path_at(uint64_t offset) const {
+            const Segment *seg = segment_at(offset);
+            return seg ? std::string_view(seg->path) : std::string_view();
+        }
+
+        /**
+         * @brief Text of the line starting at offset, without its newline
+         */
+        [[nodiscard]] std::string_view line(uint64_t start) const {
+            const Segment *seg = segment_at(start);
+            if (!seg) {
+                return {};
+            }
+            const char *p = seg->data + (start - seg->base);
+            const char *end = seg->data + seg->size;
+            const void *nl = std::memchr(p, '\n', static_cast<size_t>(end - p));
+            return std::string_view(p, static_cast<size_t>((nl ? static_cast<const char *>(nl) : end) - p));
+        }
+
+        /**
+         * @brief Start of the line after the one at start (size() if none)
+         */
+        [[nodiscard]] uint64_t next_line(uint64_t start) const {
+            const Segment *seg = segment_at(start);
+            if (!seg) {
+                return total_size_;
+            }
+            uint64_t end = start + line(start).size();
+            return end < seg->base + seg->size ? end + 1 : end;
+        }
+
+        /**
+         * @brief Start of the line containing offset
+         */
+        [[nodiscard]] uint64_t line_start(uint64_t offset) const {
+            if (offset >= total_size_) {
+                offset = total_size_ == 0 ? 0 : total_size_ - 1;
+            }
+            const Segment *seg = segment_at(offset);
+            if (!seg) {
+                return 0;
+            }
+            const char *begin = seg->data;
+            const char *p = seg->data + (offset - seg->base);
+            while (p > begin && p[-1] != '\n') {
+                --p;
+            }
+            return seg->base + static_cast<uint64_t>(p - begin);
+        }
+
+        /**
+         * @brief Start of the line before the one at start (start itself if it is the first)
+         */
+        [[nodiscard]] uint64_t prev_line(uint64_t start) const {
+            return start == 0 ? 0 : line_start(start - 1);
+        }
+
+        /**
+         * @brief Start of the last line
+         */
+        [[nodiscard]] uint64_t last_line() const { return total_size_ == 0 ? 0 : line_start(total_size_ - 1); }
+
+        /**
+         * @brief 0-based number of the line starting at start, once indexed that far
+         */
+        [[nodiscard]] std::optional<uint64_t> line_number(uint64_t start) const {
+            if (start > indexed_bytes() && !(start == 0)) {
+                return std::nullopt;
+            }
+            uint64_t checkpoint, k;
+            {
+                std::lock_guard<std::mutex> lock(index_mutex_);
+                auto it = std::upper_bound(checkpoints_.begin(), checkpoints_.end(), start);
+                k = static_cast<uint64_t>(it - checkpoints_.begin()) - 1;
+                checkpoint = checkpoints_[k];
+            }
+            return k * LINES_PER_CHECKPOINT + count_line_ends(checkpoint, start);
+        }
+
+        /**
+         * @brief Start of 0-based line n, once indexed that far
+         */
+        [[nodiscard]] std::optional<uint64_t> line_offset(uint64_t n) const {
+            if (n >= indexed_lines() && !(n == 0 && total_size_ > 0)) {
+                return std::nullopt;
+            }
+            uint64_t offset;
+            {
+                std::lock_guard<std::mutex> lock(index_mutex_);
+                uint64_t k = n / LINES_PER_CHECKPOINT;
+                if (k >= checkpoints_.size()) {
+                    return std::nullopt;
+                }
+                offset = checkpoints_[k];
+            }
+            for (uint64_t i = 0; i < n % LINES_PER_CHECKPOINT; ++i) {
+                offset = next_line(offset);
+            }
+            return offset;
+        }
+
+        /**
+         * @brief Next (or previous) line passing a filter, looking at most max_lines lines
+         * @param start Line to start after (forward) or before (backward)
+         * @return Line start, or nullopt if none was found within the budget
+         */
+        [[nodiscard]] std::optional<uint64_t> step(uint64_t start, bool forward, const ViewFilter &filter,
+                                                   uint64_t max_lines = UINT64_MAX) const {
+            uint64_t offset = start;
+            for (uint64_t i = 0; i < max_lines; ++i) {
+                if (forward) {
+                    uint64_t next = next_line(offset);
+                    if (next >= total_size_) {
+                        return std::nullopt;
+                    }
+                    offset = next;
+                } else {
+                    if (offset == 0) {
+                        return std::nullopt;
+                    }
+                    offset = prev_line(offset);
+                }
+                if (filter.matches(line(offset))) {
+                    return offset;
+                }
+            }
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Outcome of a bounded search step, see find_some()
+         */
+        struct FindProgress {
+            std::optional<uint64_t> match; ///< Start of the matching line
+            uint64_t resume = 0;           ///< Offset to pass as `from` to continue, when neither matched nor done
+            bool done = false;             ///< Reached the end (forward) or the start (backward) without a match
+        };
+
+        /**
+         * @brief Find the next line containing needle
+         * @param from Offset to search from (forward: at or after; backward: strictly before)
+         * @param forward Search direction
+         * @param filter Only lines passing this filter count (nullptr = all)
+         * @return Start of the matching line
+         */
+        [[nodiscard]] std::optional<uint64_t> find(std::string_view needle, uint64_t from, bool forward,
+                                                   const ViewFilter *filter = nullptr) const {
+            return find_some(needle, from, forward, filter, UINT64_MAX).match;
+        }
+
+        /**
+         * @brief find(), scanning roughly max_bytes before returning
+         *
+         * Lets a caller search a large view in steps (to stay responsive, show
+         * progress, or cancel): call again with `from = resume` until a match or done.
+         */
+        [[nodiscard]] FindProgress find_some(std::string_view needle, uint64_t from, bool forward,
+                                             const ViewFilter *filter, uint64_t max_bytes) const {
+            FindProgress result;
+            if (needle.empty()) {
+                result.done = true;
+                return result;
+            }
+            uint64_t budget = std::max<uint64_t>(max_bytes, 1);
+            if (forward) {
+                uint64_t pos = from;
+                while (pos < total_size_) {
+                    if (budget == 0) {
+                        result.resume = pos;
+                        return result;
+                    }
+                    const Segment *seg = segment_at(pos);
+                    uint64_t chunk_end = pos + std::min(budget, seg->base + seg->size - pos);
+                    // Overlap by needle size - 1 so matches crossing the chunk end are seen in this chunk
+                    const char *begin = seg->data + (pos - seg->base);
+                    const char *end = seg->data + std::min(chunk_end - seg->base + needle.size() - 1, seg->size);
+                    const char *hit = detail::find_substring(begin, end, needle);
+                    if (hit == end) {
+                        budget -= chunk_end - pos;
+                        pos = chunk_end;
+                        continue;
+                    }
+                    uint64_t hit_offset = seg->base + static_cast<uint64_t>(hit - seg->data);
+                    budget -= std::min(budget, hit_offset + 1 - pos);
+                    uint64_t start = line_start(hit_offset);
+                    if (!filter || filter->matches(line(start))) {
+                        result.match = start;
+                        return result;
+                    }
+                    pos = next_line(start);
+                }
+                result.done = true;
+                return result;
+            }
+
+            // Backward: search forward inside windows that move towards the start
+            constexpr uint64_t WINDOW = 1 << 20;
+            uint64_t limit = std::min(from, total_size_);
+            while (limit > 0) {
+                if (budget == 0) {
+                    result.resume = limit;
+                    return result;
+                }
+                const Segment *seg = segment_at(limit - 1);
+                uint64_t window_begin = limit - std::min({WINDOW, budget, limit - seg->base});
+                // Overlap by needle size - 1 so matches crossing the window start are seen in the next window
+                const char *begin = seg->data + (window_begin - seg->base);
+                const char *end = seg->data + std::min(limit - seg->base + needle.size() - 1, seg->size);
+                std::optional<uint64_t> best;
+                const char *p = begin;
+                while (true) {
+                    const char *hit = detail::find_substring(p, end, needle);
+                    if (hit == end) {
+                        break;
+                    }
+                    uint64_t hit_offset = seg->base + static_cast<uint64_t>(hit - seg->data);
+                    if (hit_offset >= limit) {
+                        break;
+                    }
+                    uint64_t start = line_start(hit_offset);
+                    if (!filter || filter->matches(line(start))) {
+                        best = start;
+                    }
+                    p = hit + 1;
+                }
+                if (best && *best < from) {
+                    result.match = best;
+                    return result;
+                }
+                budget -= limit - window_begin;
+                limit = window_begin;
+            }
+            result.done = true;
+            return result;
+        }
+    };
+
+#endif // __unix__
+
+} // namespace echo
@@ -43,6 +43,26 @@ namespace echo {
 #endif
         }
 
+        /**
+         * @brief Get terminal height in rows
+         * @return Terminal height (defaults to 24 if detection fails)
+         */
+        [[nodiscard]] inline int get_terminal_height() noexcept {
+#ifdef _WIN32
+            CONSOLE_SCREEN_BUFFER_INFO csbi;
+            if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi)) {
+                return csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
+            }
+            return 24; // Fallback
+#else
+            struct winsize w;
+            if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0 && w.ws_row > 0) {
+                return w.ws_row;
+            }
+            return 24; // Fallback
+#endif
+        }
+
         // =================================================================================================
         // TTY Detection
         // =================================================================================================
@@ -7,8 +7,11 @@
 
 #include <echo/echo.hpp>
 
+#include <memory>
+#include <ostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 TEST_CASE("Very long messages") {
     echo::clear_sinks();
@@ -143,3 +146,177 @@ TEST_CASE("Message boundary conditions") {
         }
     }
 }
+
+// Sink that records every message it receives
+class CaptureSink : public echo::Sink {
+  public:
+    std::vector<std::string> messages;
+
+    void write(echo::Level level, const std::string &message) override {
+        if (should_log(level)) {
+            messages.push_back(message);
+        }
+    }
+
+    void flush() override {}
+};
+
+// Counts how often it is converted
+struct Expensive {
+    static inline int conversions = 0;
+    std::string to_string() const {
+        ++conversions;
+        return std::string(1000, 'e');
+    }
+};
+
+// Streams a very large payload in small pieces, like a container dump
+struct HugeDump {
+    static inline int pieces_written = 0;
+    friend std::ostream &operator<<(std::ostream &os, const HugeDump &) {
+        for (int i = 0; i < 1000000 && os; ++i) {
+            os << "item" << i << ", ";
+            ++pieces_written;
+        }
+        return os;
+    }
+};
+
+#ifdef ECHO_HAS_STD_FORMAT
+// Formats a very large payload through std::format, counting what it produces
+struct HugeFormat {
+    static inline int pieces_written = 0;
+};
+
+template <> struct std::formatter<HugeFormat, char> {
+    constexpr auto parse(std::format_parse_context &ctx) { return ctx.begin(); }
+
+    auto format(const HugeFormat &, std::format_context &ctx) const {
+        auto out = ctx.out();
+        for (int i = 0; i < 1000000; ++i) {
+            out = std::format_to(out, "item{}, ", i);
+            ++HugeFormat::pieces_written;
+        }
+        return out;
+    }
+};
+#endif
+
+TEST_CASE("Record size cap") {
+    echo::set_level(echo::Level::Trace);
+    echo::clear_sinks();
+    auto sink = std::make_shared<CaptureSink>();
+    echo::add_sink(sink);
+
+    SUBCASE("Messages under the cap are unchanged") {
+        echo::set_max_record_size(1000);
+        CHECK(echo::detail::build_message_bounded(1000, "a=", 1, " b=", 2.5, " c=", true, ' ', std::string("s")) ==
+              echo::detail::build_message("a=", 1, " b=", 2.5, " c=", true, ' ', std::string("s")));
+        echo::info("short");
+        REQUIRE(sink->messages.size() == 1);
+        CHECK(sink->messages[0].find("short\n") != std::string::npos);
+        CHECK(sink->messages[0].find("truncated") == std::string::npos);
+    }
+
+    SUBCASE("Long strings are cut and the marker carries the original size") {
+        echo::set_max_record_size(100);
+        echo::info(std::string(70000, 'B'));
+        REQUIRE(sink->messages.size() == 1);
+        CHECK(sink->messages[0].find(std::string(100, 'B') + "... [truncated: 70000 bytes]\n") != std::string::npos);
+        CHECK(sink->messages[0].find(std::string(101, 'B')) == std::string::npos);
+
+        CHECK(echo::detail::build_message_bounded(5, 123456789) == "12345... [truncated: 9 bytes]");
+        CHECK(echo::detail::build_message_bounded(4, "abc", std::string(10, 'x')) == "abcx... [truncated: 13 bytes]");
+    }
+
+    SUBCASE("Arguments after the cap are not converted") {
+        Expensive::conversions = 0;
+        std::string message = echo::detail::build_message_bounded(10, std::string(50, 'A'), Expensive{}, Expensive{});
+        CHECK(Expensive::conversions == 0);
+        CHECK(message == std::string(10, 'A') + "... [truncated: >50 bytes]");
+    }
+
+    SUBCASE("Stream output stops soon after the cap") {
+        HugeDump::pieces_written = 0;
+        std::string message = echo::detail::build_message_bounded(1024, HugeDump{});
+        CHECK(HugeDump::pieces_written < 10000); // The full dump is 1M pieces
+        CHECK(message.size() < 1100);
+        CHECK(message.find("... [truncated: >") != std::string::npos);
+    }
+
+#ifdef ECHO_HAS_STD_FORMAT
+    SUBCASE("std::format output stops soon after the cap") {
+        HugeFormat::pieces_written = 0;
+        std::string message = echo::detail::build_message_bounded(1024, HugeFormat{});
+        CHECK(HugeFormat::pieces_written < 10000); // The full output is 1M pieces
+        CHECK(message.size() < 1100);
+        CHECK(message.find("... [truncated: >") != std::string::npos);
+    }
+#endif
+
+    SUBCASE("UTF-8 sequences are not split") {
+        // "é" is two bytes: a cap of 3 keeps one character
+        CHECK(echo::detail::build_message_bounded(3, "\xC3\xA9\xC3\xA9") == "\xC3\xA9... [truncated: 4 bytes]");
+    }
+
+    SUBCASE("Category caps override the global cap") {
+        echo::set_max_record_size(10);
+        echo::set_category_max_record_size("http.*", 20);
+        echo::set_category_max_record_size("raw", 0);
+
+        std::string payload(100, 'p');
+        echo::category("http.body").info(payload);
+        echo::category("raw").info(payload);
+        echo::category("db").info(payload);
+        REQUIRE(sink->messages.size() == 3);
+        CHECK(sink->messages[0].find(std::string(20, 'p') + "... [truncated: 100 bytes]") != std::string::npos);
+        CHECK(sink->messages[1].find(payload + "\n") != std::string::npos);
+        CHECK(sink->messages[2].find(std::string(10, 'p') + "... [truncated: 100 bytes]") != std::string::npos);
+        echo::clear_category_max_record_sizes();
+    }
+
+    SUBCASE("Sink caps apply to that sink only") {
+        auto small = std::make_shared<CaptureSink>();
+        small->set_max_record_size(16);
+        echo::add_sink(small);
+
+        echo::error(std::string(200, 'x'));
+        REQUIRE(sink->messages.size() == 1);
+        REQUIRE(small->messages.size() == 1);
+        CHECK(sink->messages[0].find(std::string(200, 'x')) != std::string::npos);
+        // "[error] " and 8 of the x: colors do not count towards the cap and are reset
+        const std::string &line = small->messages[0];
+        CHECK(line.find(std::string(8, 'x') + "\033[0m... [truncated: 208 bytes]\n") != std::string::npos);
+        CHECK(line.find(std::string(9, 'x')) == std::string::npos);
+
+        echo::block().info("ok").error(std::string(200, 'y'));
+        REQUIRE(small->messages.size() == 2);
+        CHECK(small->messages[1].find("ok\n") != std::string::npos);
+        CHECK(small->messages[1].find("... [truncated: ") != std::string::npos);
+        CHECK(sink->messages[1].find(std::string(200, 'y')) != std::string::npos);
+    }
+
+    SUBCASE("Formatters cut the message while appending") {
+        echo::PatternFormatter pattern("[{level}] {msg} <end>");
+        pattern.set_max_record_size(20);
+        std::string message(1000, 'm');
+        echo::LogRecordView record;
+        record.level = echo::Level::Info;
+        record.message = message;
+
+        std::string out;
+        pattern.format_to(out, record);
+        CHECK(out == "[info] " + std::string(13, 'm') + "... [truncated: 1000 bytes] <end>");
+        CHECK(pattern.clone()->max_record_size() == 20);
+
+        echo::CustomFormatter custom(echo::CustomFormatter::AppendFunc(
+            [](std::string &buffer, const echo::LogRecordView &r) { buffer.append(r.message); }));
+        custom.set_max_record_size(10);
+        out.clear();
+        custom.format_to(out, record);
+        CHECK(out == std::string(10, 'm') + "... [truncated: 1000 bytes]");
+    }
+
+    echo::set_max_record_size(0);
+    echo::clear_sinks();
+}
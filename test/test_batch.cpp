@@ -0,0 +1,146 @@
+/**
+ * @file test_batch.cpp
+ * @brief Test SoA batch rendering
+ */
+
+#include <doctest/doctest.h>
+
+#include <echo/echo.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 2024-03-01 13:05:09 UTC, in nanoseconds
+static constexpr int64_t BASE_NS = 1709298309LL * 1000000000LL;
+
+TEST_CASE("Clock kernel matches the scalar reference") {
+    // Every second of the day, with varying sub-second parts
+    const size_t n = 86400 + 5; // Not a multiple of 8: exercises the tail
+    std::vector<uint32_t> sod(n), ms(n), us(n);
+    for (size_t i = 0; i < n; ++i) {
+        sod[i] = static_cast<uint32_t>(i % 86400);
+        ms[i] = static_cast<uint32_t>((i * 7) % 1000);
+        us[i] = static_cast<uint32_t>((i * 13) % 1000);
+    }
+    std::vector<char> fast(n * echo::detail::CLOCK_ROW), reference(n * echo::detail::CLOCK_ROW);
+    echo::detail::render_clock_rows(sod.data(), ms.data(), us.data(), n, fast.data());
+    echo::detail::render_clock_rows_scalar(sod.data(), ms.data(), us.data(), n, reference.data());
+    CHECK(fast == reference);
+
+    CHECK(std::string(reference.data() + 86399 * echo::detail::CLOCK_ROW, 16) == "23:59:59.793187 ");
+    CHECK(std::string(reference.data(), 16) == "00:00:00.000000 ");
+}
+
+TEST_CASE("BatchRenderer") {
+    echo::BatchRendererOptions options;
+    options.utc = true;
+
+    SUBCASE("Lines carry timestamp, level, category and message") {
+        echo::BatchRenderer renderer(options);
+        uint16_t net = renderer.add_category("net");
+        CHECK(renderer.add_category("net") == net);
+        CHECK(renderer.category_name(net) == "net");
+
+        echo::RecordBatch batch;
+        batch.push(BASE_NS + 7000000, echo::Level::Info, net, "connected");
+        batch.push(BASE_NS + 1999000000, echo::Level::Error, echo::RecordBatch::NO_CATEGORY, "lost");
+        CHECK(batch.message(1) == "lost");
+
+        echo::LogBlock block;
+        renderer.render(batch, block);
+        CHECK(block.text == "[13:05:09.007][info] [net] connected\n"
+                            "[13:05:10.999][error] lost\n");
+        REQUIRE(block.lines.size() == 2);
+        CHECK(block.lines[1].level == echo::Level::Error);
+        CHECK(block.text.substr(block.lines[1].begin, block.lines[1].end - block.lines[1].begin) ==
+              "[13:05:10.999][error] lost\n");
+    }
+
+    SUBCASE("Precision options") {
+        echo::RecordBatch batch;
+        batch.push(BASE_NS + 123456789, echo::Level::Warn, echo::RecordBatch::NO_CATEGORY, "x");
+
+        options.precision = echo::TimestampPrecision::Micros;
+        std::string micros;
+        echo::BatchRenderer(options).render(batch, micros);
+        CHECK(micros == "[13:05:09.123456][warning] x\n");
+
+        options.precision = echo::TimestampPrecision::Seconds;
+        std::string seconds;
+        echo::BatchRenderer(options).render(batch, seconds);
+        CHECK(seconds == "[13:05:09][warning] x\n");
+
+        options.precision = echo::TimestampPrecision::None;
+        std::string none;
+        echo::BatchRenderer(options).render(batch, none);
+        CHECK(none == "[warning] x\n");
+    }
+
+    SUBCASE("Large batches render identically record by record") {
+        echo::BatchRenderer renderer(options);
+        uint16_t db = renderer.add_category("db");
+        echo::RecordBatch batch;
+        for (int i = 0; i < 1000; ++i) {
+            batch.push(BASE_NS + i * 1234567LL, static_cast<echo::Level>(i % 6), i % 3 ? db : 0xFFFF,
+                       "message " + std::to_string(i));
+        }
+
+        std::string all;
+        renderer.render(batch, all);
+
+        std::string one_by_one;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            echo::RecordBatch single;
+            single.push(batch.timestamps[i], batch.levels[i], batch.categories[i], batch.message(i));
+            renderer.render(single, one_by_one);
+        }
+        CHECK(all == one_by_one);
+    }
+
+    SUBCASE("Timestamps before the epoch") {
+        echo::RecordBatch batch;
+        batch.push(-1, echo::Level::Info, echo::RecordBatch::NO_CATEGORY, "m");
+        std::string out;
+        echo::BatchRenderer(options).render(batch, out);
+        CHECK(out == "[23:59:59.999][info] m\n");
+    }
+
+    SUBCASE("Out-of-range levels render as unknown") {
+        echo::RecordBatch batch;
+        batch.push(BASE_NS, static_cast<echo::Level>(42), echo::RecordBatch::NO_CATEGORY, "a");
+        batch.push(BASE_NS, echo::Level::Info, echo::RecordBatch::NO_CATEGORY, "b");
+        batch.levels[1] = static_cast<echo::Level>(-1);
+        options.precision = echo::TimestampPrecision::None;
+        std::string out;
+        echo::BatchRenderer(options).render(batch, out);
+        CHECK(out == "[unknown] a\n[unknown] b\n");
+    }
+}
+
+TEST_CASE("ConsoleSink writes blocks per stream run") {
+    std::ostringstream out, err;
+    echo::detail::console_targets().out.store(&out);
+    echo::detail::console_targets().err.store(&err);
+
+    echo::BatchRendererOptions options;
+    options.precision = echo::TimestampPrecision::None;
+    echo::BatchRenderer renderer(options);
+    echo::RecordBatch batch;
+    batch.push(0, echo::Level::Info, echo::RecordBatch::NO_CATEGORY, "a");
+    batch.push(0, echo::Level::Error, echo::RecordBatch::NO_CATEGORY, "b");
+    batch.push(0, echo::Level::Debug, echo::RecordBatch::NO_CATEGORY, "c");
+    batch.push(0, echo::Level::Info, echo::RecordBatch::NO_CATEGORY, "d");
+    echo::LogBlock block;
+    renderer.render(batch, block);
+
+    echo::ConsoleSink sink;
+    sink.set_level(echo::Level::Info);
+    sink.write_block(block);
+
+    echo::detail::console_targets().out.store(nullptr);
+    echo::detail::console_targets().err.store(nullptr);
+
+    CHECK(out.str() == "[info] a\n[info] d\n");
+    CHECK(err.str() == "[error] b\n");
+}
@@ -0,0 +1,217 @@
+/**
+ * @file test_block.cpp
+ * @brief Test multi-line log blocks written as one unit
+ */
+
+#include <doctest/doctest.h>
+
+#define ECHO_ENABLE_FILE_SINK
+#include <echo/echo.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Sink that records every write() call as one entry
+class WriteRecorder : public echo::Sink {
+  private:
+    std::vector<std::pair<echo::Level, std::string>> writes_;
+    mutable std::mutex mutex_;
+
+  public:
+    void write(echo::Level level, const std::string &message) override {
+        if (!should_log(level)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        writes_.emplace_back(level, message);
+    }
+
+    void flush() override {}
+
+    [[nodiscard]] std::vector<std::pair<echo::Level, std::string>> writes() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return writes_;
+    }
+};
+
+static size_t count_lines(const std::string &text) {
+    size_t n = 0;
+    for (char c : text) {
+        n += (c == '\n');
+    }
+    return n;
+}
+
+TEST_CASE("echo::block") {
+    echo::set_level(echo::Level::Trace);
+    echo::clear_sinks();
+    auto sink = std::make_shared<WriteRecorder>();
+    echo::add_sink(sink);
+
+    SUBCASE("RAII block is written once on destruction") {
+        {
+            echo::block b;
+            b.info("header");
+            b.debug("detail ", 42);
+            b.warn("summary");
+            CHECK(b.size() == 3);
+            CHECK(sink->writes().empty());
+        }
+
+        auto writes = sink->writes();
+        REQUIRE(writes.size() == 1);
+        CHECK(writes[0].first == echo::Level::Warn); // highest line level
+        CHECK(count_lines(writes[0].second) == 3);
+        CHECK(writes[0].second.find("header") < writes[0].second.find("detail 42"));
+        CHECK(writes[0].second.find("detail 42") < writes[0].second.find("summary"));
+    }
+
+    SUBCASE("Builder chain is written at the end of the statement") {
+        echo::block().info("a").info("b").info("c");
+
+        auto writes = sink->writes();
+        REQUIRE(writes.size() == 1);
+        CHECK(count_lines(writes[0].second) == 3);
+    }
+
+    SUBCASE("submit() and discard()") {
+        echo::block b;
+        b.info("first");
+        b.submit();
+        CHECK(b.empty());
+        b.info("dropped");
+        b.discard();
+        CHECK(b.empty());
+
+        auto writes = sink->writes();
+        REQUIRE(writes.size() == 1);
+        CHECK(writes[0].second.find("first") != std::string::npos);
+    }
+
+    SUBCASE("Empty block writes nothing") {
+        { echo::block b; }
+        CHECK(sink->writes().empty());
+    }
+
+    SUBCASE("Runtime level filters lines") {
+        echo::set_level(echo::Level::Info);
+        echo::block().debug("hidden").info("shown");
+
+        auto writes = sink->writes();
+        REQUIRE(writes.size() == 1);
+        CHECK(writes[0].second.find("hidden") == std::string::npos);
+        CHECK(writes[0].second.find("shown") != std::string::npos);
+        echo::set_level(echo::Level::Trace);
+    }
+
+    SUBCASE("Sink level filters lines, remaining lines still one write") {
+        sink->set_level(echo::Level::Warn);
+        echo::block().info("low").error("high 1").debug("low").critical("high 2");
+
+        auto writes = sink->writes();
+        REQUIRE(writes.size() == 1);
+        CHECK(writes[0].first == echo::Level::Critical);
+        CHECK(count_lines(writes[0].second) == 2);
+        CHECK(writes[0].second.find("low") == std::string::npos);
+    }
+
+    SUBCASE("Sink level filters every line") {
+        sink->set_level(echo::Level::Error);
+        echo::block().info("a").warn("b");
+        CHECK(sink->writes().empty());
+    }
+
+    SUBCASE("Moved-from block does not write") {
+        echo::block a;
+        a.info("moved");
+        {
+            echo::block b(std::move(a));
+        }
+        CHECK(sink->writes().size() == 1);
+    }
+
+    SUBCASE("Concurrent blocks are not interleaved") {
+        const int threads = 8;
+        const int blocks_per_thread = 50;
+        const int lines_per_block = 5;
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([t] {
+                for (int i = 0; i < blocks_per_thread; ++i) {
+                    echo::block b;
+                    for (int l = 0; l < lines_per_block; ++l) {
+                        b.info("T", t, " B", i, " L", l);
+                    }
+                }
+            });
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+
+        auto writes = sink->writes();
+        REQUIRE(writes.size() == threads * blocks_per_thread);
+        for (const auto &[level, text] : writes) {
+            CHECK(count_lines(text) == lines_per_block);
+            // Every line of a unit comes from the same thread and block
+            size_t tag_end = text.find(" L0");
+            REQUIRE(tag_end != std::string::npos);
+            size_t tag_begin = text.rfind('T', tag_end);
+            std::string tag = text.substr(tag_begin, tag_end - tag_begin);
+            for (int l = 0; l < lines_per_block; ++l) {
+                CHECK(text.find(tag + " L" + std::to_string(l)) != std::string::npos);
+            }
+        }
+    }
+
+    SUBCASE("FileSink receives each block contiguously") {
+        const std::string path = "test_block.log";
+        std::remove(path.c_str());
+        echo::clear_sinks();
+        {
+            auto file = std::make_shared<echo::FileSink>(path);
+            echo::add_sink(file);
+
+            std::vector<std::thread> workers;
+            for (int t = 0; t < 4; ++t) {
+                workers.emplace_back([t] {
+                    for (int i = 0; i < 25; ++i) {
+                        echo::info("single ", t);
+                        echo::block().info("begin ", t).info("middle ", t).info("end ", t);
+                    }
+                });
+            }
+            for (auto &w : workers) {
+                w.join();
+            }
+            echo::clear_sinks();
+        }
+
+        std::ifstream in(path);
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(in, line);) {
+            lines.push_back(line);
+        }
+        int blocks = 0;
+        for (size_t i = 0; i < lines.size(); ++i) {
+            size_t pos = lines[i].find("begin ");
+            if (pos == std::string::npos) {
+                continue;
+            }
+            REQUIRE(i + 2 < lines.size());
+            std::string id = lines[i].substr(pos + 6);
+            CHECK(lines[i + 1].find("middle " + id) != std::string::npos);
+            CHECK(lines[i + 2].find("end " + id) != std::string::npos);
+            ++blocks;
+        }
+        CHECK(blocks == 100);
+        std::remove(path.c_str());
+    }
+
+    echo::clear_sinks();
+}
@@ -0,0 +1,193 @@
+/**
+ * @file test_capture.cpp
+ * @brief Test capture of foreign stdout/stderr output
+ */
+
+#include <doctest/doctest.h>
+
+#include <echo/echo.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Sink that records level and message of every write
+class RecordingSink : public echo::Sink {
+  private:
+    std::vector<std::pair<echo::Level, std::string>> records_;
+    mutable std::mutex mutex_;
+
+  public:
+    void write(echo::Level level, const std::string &message) override {
+        if (!should_log(level)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        records_.emplace_back(level, message);
+    }
+
+    void flush() override {}
+
+    [[nodiscard]] std::vector<std::pair<echo::Level, std::string>> records() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return records_;
+    }
+
+    [[nodiscard]] bool wait_for(size_t count, std::chrono::milliseconds timeout = std::chrono::seconds(2)) const {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (records().size() >= count) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return records().size() >= count;
+    }
+};
+
+static bool contains(const std::string &haystack, const std::string &needle) {
+    return haystack.find(needle) != std::string::npos;
+}
+
+TEST_CASE("StdioCapture") {
+    echo::set_level(echo::Level::Trace);
+    echo::clear_category_levels();
+    echo::clear_sinks();
+    auto sink = std::make_shared<RecordingSink>();
+    echo::add_sink(sink);
+
+    SUBCASE("printf and fprintf(stderr) become records") {
+        echo::StdioCapture capture;
+        REQUIRE(capture.start());
+        CHECK(capture.active());
+
+        std::printf("from printf %d\n", 1);
+        std::fflush(stdout);
+        std::fprintf(stderr, "from stderr\n");
+        CHECK(sink->wait_for(2));
+        capture.stop();
+        CHECK_FALSE(capture.active());
+
+        auto records = sink->records();
+        REQUIRE(records.size() == 2);
+        bool seen_out = false, seen_err = false;
+        for (const auto &[level, message] : records) {
+            if (contains(message, "[stdout] from printf 1")) {
+                seen_out = true;
+                CHECK(level == echo::Level::Info);
+            }
+            if (contains(message, "[stderr] from stderr")) {
+                seen_err = true;
+                CHECK(level == echo::Level::Warn);
+            }
+        }
+        CHECK(seen_out);
+        CHECK(seen_err);
+    }
+
+    SUBCASE("Raw writes are split into lines; partial line is flushed on stop") {
+        echo::StdioCapture capture;
+        REQUIRE(capture.start());
+
+        const char data[] = "one\ntwo\r\nthr";
+        ssize_t written = ::write(STDOUT_FILENO, data, sizeof(data) - 1);
+        CHECK(written == static_cast<ssize_t>(sizeof(data) - 1));
+        CHECK(sink->wait_for(2));
+        capture.stop();
+
+        auto records = sink->records();
+        REQUIRE(records.size() == 3);
+        CHECK(contains(records[0].second, "[stdout] one\n"));
+        CHECK(contains(records[1].second, "[stdout] two\n"));
+        CHECK(contains(records[2].second, "[stdout] thr\n"));
+    }
+
+    SUBCASE("Custom category, level and no tag") {
+        echo::StdioCaptureOptions options;
+        options.capture_stderr = false;
+        options.stdout_category = "vendor.lib";
+        options.stdout_level = echo::Level::Debug;
+        options.tag_lines = false;
+
+        echo::StdioCapture capture(options);
+        REQUIRE(capture.start());
+        std::printf("hello\n");
+        std::fflush(stdout);
+        CHECK(sink->wait_for(1));
+        capture.stop();
+
+        auto records = sink->records();
+        REQUIRE(records.size() == 1);
+        CHECK(records[0].first == echo::Level::Debug);
+        CHECK(contains(records[0].second, "hello"));
+        CHECK_FALSE(contains(records[0].second, "vendor.lib"));
+    }
+
+    SUBCASE("Category levels filter captured lines") {
+        echo::set_category_level("stdout", echo::Level::Error);
+
+        echo::StdioCapture capture;
+        REQUIRE(capture.start());
+        std::printf("suppressed\n");
+        std::fflush(stdout);
+        std::fprintf(stderr, "kept\n");
+        CHECK(sink->wait_for(1));
+        capture.stop();
+
+        auto records = sink->records();
+        REQUIRE(records.size() == 1);
+        CHECK(contains(records[0].second, "kept"));
+        echo::clear_category_levels();
+    }
+
+    SUBCASE("Echo's own console output is not captured again") {
+        echo::add_sink(std::make_shared<echo::ConsoleSink>());
+
+        echo::StdioCapture capture;
+        REQUIRE(capture.start());
+        echo::info("direct log");
+        std::printf("foreign\n");
+        std::fflush(stdout);
+        CHECK(sink->wait_for(2));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        capture.stop();
+
+        // One record for the log call, one for the foreign line; none re-captured from the console
+        CHECK(sink->records().size() == 2);
+    }
+
+    SUBCASE("Writing to stdout under the log mutex does not deadlock") {
+        echo::StdioCapture capture;
+        REQUIRE(capture.start());
+
+        // More than a pipe buffer: the writer needs the reader to drain while it holds the mutex
+        const std::string line = std::string(1023, 'x') + "\n";
+        std::thread writer([&] {
+            std::lock_guard<std::mutex> lock(echo::detail::get_log_mutex());
+            for (int i = 0; i < 256; ++i) {
+                ssize_t written = ::write(STDOUT_FILENO, line.data(), line.size());
+                CHECK(written == static_cast<ssize_t>(line.size()));
+            }
+        });
+        writer.join();
+        CHECK(sink->wait_for(256));
+        capture.stop();
+        CHECK(sink->records().size() == 256);
+    }
+
+    SUBCASE("Only one capture at a time") {
+        echo::StdioCapture first;
+        echo::StdioCapture second;
+        REQUIRE(first.start());
+        CHECK_FALSE(second.start());
+        first.stop();
+        CHECK(second.start());
+        second.stop();
+    }
+
+    echo::clear_sinks();
+}
@@ -0,0 +1,223 @@
+/**
+ * @file test_failover_sink.cpp
+ * @brief Test failover chains with latency and error SLOs
+ */
+
+#include <doctest/doctest.h>
+
+#define ECHO_ENABLE_FAILOVER_SINK
+#define ECHO_ENABLE_NETWORK_SINK
+#include <echo/echo.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Sink whose latency and failure mode can be changed at runtime
+class ControlledSink : public echo::Sink {
+  private:
+    std::vector<std::string> messages_;
+    mutable std::mutex mutex_;
+
+  public:
+    std::atomic<int> delay_us{0};
+    std::atomic<bool> throws{false};
+    std::atomic<bool> broken{false};
+
+    void write(echo::Level level, const std::string &message) override {
+        if (!should_log(level)) {
+            return;
+        }
+        if (delay_us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(delay_us.load()));
+        }
+        if (throws) {
+            throw std::runtime_error("write failed");
+        }
+        if (broken) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        messages_.push_back(message);
+    }
+
+    void flush() override {}
+
+    [[nodiscard]] bool healthy() const override { return !broken; }
+
+    [[nodiscard]] size_t message_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_.size();
+    }
+};
+
+TEST_CASE("FailoverSink") {
+    auto primary = std::make_shared<ControlledSink>();
+    auto secondary = std::make_shared<ControlledSink>();
+
+    echo::FailoverPolicy policy;
+    policy.max_p99 = std::chrono::milliseconds(1);
+    policy.window = 32;
+    policy.min_samples = 4;
+    policy.retry_interval = std::chrono::milliseconds(0);
+    policy.recovery_probes = 3;
+
+    auto chain = std::make_shared<echo::FailoverSink>(std::vector<echo::SinkPtr>{primary, secondary}, policy);
+
+    std::vector<echo::FailoverTransition> transitions;
+    chain->set_transition_callback([&](const echo::FailoverTransition &t) { transitions.push_back(t); });
+
+    SUBCASE("Healthy primary receives everything") {
+        for (int i = 0; i < 10; ++i) {
+            chain->write(echo::Level::Info, "msg\n");
+        }
+        CHECK(primary->message_count() == 10);
+        CHECK(secondary->message_count() == 0);
+        CHECK(chain->active_index() == 0);
+        CHECK(transitions.empty());
+    }
+
+    SUBCASE("Errors fail over and re-send the failed record") {
+        primary->throws = true;
+        policy.retry_interval = std::chrono::hours(1);
+        chain = std::make_shared<echo::FailoverSink>(std::vector<echo::SinkPtr>{primary, secondary}, policy);
+        chain->set_transition_callback([&](const echo::FailoverTransition &t) { transitions.push_back(t); });
+
+        chain->write(echo::Level::Info, "first\n");
+        CHECK(chain->active_index() == 1);
+        CHECK(secondary->message_count() == 1);
+
+        chain->write(echo::Level::Info, "second\n");
+        CHECK(secondary->message_count() == 2);
+
+        REQUIRE(transitions.size() == 1);
+        CHECK(transitions[0].from == 0);
+        CHECK(transitions[0].to == 1);
+        CHECK(transitions[0].reason == echo::FailoverReason::Errors);
+
+        auto stats = chain->stats();
+        CHECK(stats.failovers == 1);
+        CHECK(stats.children[0].errors == 1);
+        CHECK(stats.children[0].failed);
+    }
+
+    SUBCASE("Unhealthy sink counts as an error") {
+        primary->broken = true;
+        chain->write(echo::Level::Info, "lost\n");
+        CHECK(chain->active_index() == 1);
+        CHECK(secondary->message_count() == 1);
+    }
+
+    SUBCASE("Latency SLO breach fails over") {
+        policy.retry_interval = std::chrono::hours(1);
+        chain = std::make_shared<echo::FailoverSink>(std::vector<echo::SinkPtr>{primary, secondary}, policy);
+        chain->set_transition_callback([&](const echo::FailoverTransition &t) { transitions.push_back(t); });
+
+        primary->delay_us = 3000;
+        for (int i = 0; i < 8 && chain->active_index() == 0; ++i) {
+            chain->write(echo::Level::Info, "slow\n");
+        }
+        CHECK(chain->active_index() == 1);
+        REQUIRE(transitions.size() == 1);
+        CHECK(transitions[0].reason == echo::FailoverReason::Latency);
+        CHECK(transitions[0].p99 > std::chrono::milliseconds(1));
+    }
+
+    SUBCASE("Fails back after recovery probes") {
+        primary->throws = true;
+        chain->write(echo::Level::Info, "fail\n");
+        CHECK(chain->active_index() == 1);
+
+        // Still failing: probes go to primary, fail, and land on secondary
+        chain->write(echo::Level::Info, "probe\n");
+        CHECK(chain->active_index() == 1);
+        CHECK(secondary->message_count() == 2);
+
+        primary->throws = false;
+        for (int i = 0; i < 3; ++i) {
+            chain->write(echo::Level::Info, "probe ok\n");
+        }
+        CHECK(chain->active_index() == 0);
+        CHECK(primary->message_count() == 3);
+
+        REQUIRE(transitions.size() == 2);
+        CHECK(transitions[1].from == 1);
+        CHECK(transitions[1].to == 0);
+        CHECK(transitions[1].reason == echo::FailoverReason::Recovered);
+
+        auto stats = chain->stats();
+        CHECK(stats.failovers == 1);
+        CHECK(stats.failbacks == 1);
+        CHECK_FALSE(stats.children[0].failed);
+    }
+
+    SUBCASE("Records the recovering sink filters are not probes") {
+        primary->throws = true;
+        chain->write(echo::Level::Info, "fail\n");
+        CHECK(chain->active_index() == 1);
+
+        primary->throws = false;
+        primary->set_level(echo::Level::Error);
+        for (int i = 0; i < 5; ++i) {
+            chain->write(echo::Level::Info, "filtered by primary\n");
+        }
+        CHECK(chain->active_index() == 1); // Filtered writes do not count as good probes
+        CHECK(secondary->message_count() == 6);
+
+        for (int i = 0; i < 3; ++i) {
+            chain->write(echo::Level::Error, "probe ok\n");
+        }
+        CHECK(chain->active_index() == 0);
+        CHECK(primary->message_count() == 3);
+    }
+
+    SUBCASE("Last sink in the chain keeps receiving") {
+        primary->throws = true;
+        secondary->broken = true;
+        chain->write(echo::Level::Info, "a\n");
+        chain->write(echo::Level::Info, "b\n");
+        CHECK(chain->active_index() == 1);
+        CHECK(chain->stats().failovers == 1);
+    }
+
+    SUBCASE("Composes with the registry") {
+        echo::clear_sinks();
+        echo::add_sink(chain);
+        echo::info("through registry");
+        CHECK(primary->message_count() == 1);
+        echo::clear_sinks();
+    }
+
+    SUBCASE("Level filtering and flush") {
+        chain->set_level(echo::Level::Warn);
+        chain->write(echo::Level::Info, "filtered\n");
+        CHECK(primary->message_count() == 0);
+        CHECK_NOTHROW(chain->flush());
+        CHECK(chain->size() == 2);
+    }
+}
+
+TEST_CASE("FailoverSink does not deliver a failed-over record twice") {
+    auto net = std::make_shared<echo::NetworkSink>("127.0.0.1", 1); // Nothing listens: writes are buffered
+    auto spool = std::make_shared<ControlledSink>();
+    echo::FailoverPolicy policy;
+    policy.retry_interval = std::chrono::milliseconds(0);
+    echo::FailoverSink chain({net, spool}, policy);
+
+    chain.write(echo::Level::Info, "first\n");
+    CHECK(chain.active_index() == 1);
+    CHECK(spool->message_count() == 1);
+    CHECK(net->get_buffer_count() == 0); // Re-sent to the spool, so not kept for reconnect
+
+    // A failed probe lands on the spool and is not kept by the network sink either
+    chain.write(echo::Level::Info, "probe\n");
+    CHECK(spool->message_count() == 2);
+    CHECK(net->get_buffer_count() == 0);
+
+    // Without a failover the network sink keeps buffering as before
+    net->write(echo::Level::Info, "direct\n");
+    CHECK(net->get_buffer_count() == 1);
+}
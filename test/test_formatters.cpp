@@ -295,3 +295,107 @@ TEST_CASE("Formatter system") {
         CHECK(sink1->get_message(2).find("Error message") != std::string::npos);
     }
 }
+
+TEST_CASE("Append-style formatter interface") {
+    echo::LogRecord record;
+    record.level = echo::Level::Debug;
+    record.message = "Debug info";
+    record.timestamp = "2026-01-07 12:34:56";
+    record.file = "test.cpp";
+    record.line = 42;
+    record.function = "test_function";
+    record.thread_id = 12345;
+
+    SUBCASE("format_to appends to existing buffer") {
+        echo::PatternFormatter formatter("{level}: {msg}");
+        std::string buffer = "prefix|";
+        formatter.format_to(buffer, record);
+        CHECK(buffer == "prefix|debug: Debug info");
+    }
+
+    SUBCASE("format_to matches format for all built-in formatters") {
+        echo::DefaultFormatter def;
+        echo::PatternFormatter pattern("[{timestamp}] {file}:{line} {func} <{thread}> {level} {message}");
+        echo::CustomFormatter custom([](const echo::LogRecord &rec) { return "C:" + rec.message; });
+
+        for (echo::Formatter *f : {static_cast<echo::Formatter *>(&def), static_cast<echo::Formatter *>(&pattern),
+                                   static_cast<echo::Formatter *>(&custom)}) {
+            std::string buffer;
+            f->format_to(buffer, record);
+            CHECK(buffer == f->format(record));
+        }
+        CHECK(pattern.format(record) == "[2026-01-07 12:34:56] test.cpp:42 test_function <12345> debug Debug info");
+    }
+
+    SUBCASE("LogRecordView with static call-site data") {
+        std::string message = "view message";
+        echo::LogRecordView view;
+        view.level = echo::Level::Warn;
+        view.message = message;
+        view.file = __FILE__;
+        view.line = 7;
+        view.function = "caller";
+
+        echo::PatternFormatter formatter("{level} {func}:{line} {msg}{file}");
+        std::string buffer;
+        formatter.format_to(buffer, view);
+        CHECK(buffer == std::string("warning caller:7 view message") + __FILE__);
+    }
+
+    SUBCASE("Reused buffer keeps its capacity") {
+        echo::PatternFormatter formatter("[{time}][{level}] {msg}");
+        std::string buffer;
+        formatter.format_to(buffer, record);
+        const size_t capacity = buffer.capacity();
+        const char *data = buffer.data();
+
+        for (int i = 0; i < 100; ++i) {
+            buffer.clear();
+            formatter.format_to(buffer, record);
+        }
+        CHECK(buffer.capacity() == capacity);
+        CHECK(buffer.data() == data);
+    }
+
+    SUBCASE("PatternFormatter edge cases") {
+        echo::PatternFormatter unknown("{unknown} {level} {");
+        CHECK(unknown.format(record) == "{unknown} debug {");
+
+        echo::PatternFormatter braces("{{level}}");
+        CHECK(braces.format(record) == "{debug}");
+
+        // Placeholders inside the message are not expanded
+        echo::LogRecord tricky = record;
+        tricky.message = "{level}";
+        echo::PatternFormatter msg_only("{msg}");
+        CHECK(msg_only.format(tricky) == "{level}");
+
+        echo::PatternFormatter changed("{level}");
+        changed.set_pattern("{line}/{thread}");
+        CHECK(changed.format(record) == "42/12345");
+    }
+
+    SUBCASE("CustomFormatter append function") {
+        echo::CustomFormatter formatter([](std::string &out, const echo::LogRecordView &rec) {
+            out += ">> ";
+            out += rec.message;
+        });
+        std::string buffer;
+        formatter.format_to(buffer, record);
+        CHECK(buffer == ">> Debug info");
+        CHECK(formatter.format(record) == ">> Debug info");
+        CHECK(formatter.clone()->format(record) == ">> Debug info");
+    }
+
+    SUBCASE("Legacy string-returning subclass still works") {
+        struct LegacyFormatter : echo::StringFormatterAdapter {
+            std::string format(const echo::LogRecord &rec) override { return "legacy " + rec.message; }
+            std::unique_ptr<echo::Formatter> clone() const override { return std::make_unique<LegacyFormatter>(); }
+        };
+
+        LegacyFormatter formatter;
+        std::string buffer = "> ";
+        formatter.format_to(buffer, record);
+        CHECK(buffer == "> legacy Debug info");
+    }
+}
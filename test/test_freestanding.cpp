@@ -0,0 +1,118 @@
+/**
+ * @file test_freestanding.cpp
+ * @brief Test the low-footprint freestanding profile
+ */
+
+#include <doctest/doctest.h>
+
+#define ECHO_FREESTANDING
+#define ECHO_LINE_BUFFER_SIZE 64
+#include <echo/echo.hpp>
+
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Captured {
+    std::vector<std::string> lines;
+    std::vector<echo::Level> levels;
+};
+
+static void capture_line(echo::Level level, const char *data, size_t size, void *user) {
+    auto *captured = static_cast<Captured *>(user);
+    captured->lines.emplace_back(data, size);
+    captured->levels.push_back(level);
+}
+
+static int lock_depth = 0;
+static int lock_calls = 0;
+
+TEST_CASE("Freestanding profile") {
+    Captured captured;
+    echo::set_write_callback(capture_line, &captured);
+    echo::set_level(echo::Level::Trace);
+    echo::reset_stats();
+
+    SUBCASE("Lines go to the write callback") {
+        CHECK(echo::info("hello ", 42) == echo::Status::Ok);
+        CHECK(echo::error("bad") == echo::Status::Ok);
+
+        REQUIRE(captured.lines.size() == 2);
+        CHECK(captured.lines[0] == "[info] hello 42\n");
+        CHECK(captured.lines[1] == "[error] bad\n");
+        CHECK(captured.levels[1] == echo::Level::Error);
+        CHECK(echo::stats().written == 2);
+    }
+
+    SUBCASE("Integer conversions") {
+        echo::info(0, ' ', -7, ' ', 18446744073709551615ULL, ' ', LLONG_MIN, ' ', static_cast<uint8_t>(200));
+        REQUIRE(captured.lines.size() == 1);
+        CHECK(captured.lines[0] == "[info] 0 -7 18446744073709551615 -9223372036854775808 200\n");
+    }
+
+    SUBCASE("Floating point conversions") {
+        echo::info(3.14159, ' ', -0.5f, ' ', 2.0, ' ', 0.9999);
+        REQUIRE(captured.lines.size() == 1);
+        CHECK(captured.lines[0] == "[info] 3.142 -0.500 2.000 1.000\n");
+
+        echo::info(1e20);
+        CHECK(captured.lines[1] == "[info] 1.000e+20\n");
+    }
+
+    SUBCASE("Other argument types") {
+        const char *null_str = nullptr;
+        std::string owned = "owned";
+        echo::info(true, ' ', 'x', ' ', null_str, ' ', owned, ' ', std::string_view("view"));
+        REQUIRE(captured.lines.size() == 1);
+        CHECK(captured.lines[0] == "[info] true x (null) owned view\n");
+
+        echo::info(reinterpret_cast<const void *>(uintptr_t{0x1f}));
+        CHECK(captured.lines[1] == "[info] 0x1f\n");
+    }
+
+    SUBCASE("Long lines are truncated, newline kept") {
+        std::string long_text(200, 'a');
+        CHECK(echo::warn(long_text) == echo::Status::Truncated);
+
+        REQUIRE(captured.lines.size() == 1);
+        CHECK(captured.lines[0].size() == ECHO_LINE_BUFFER_SIZE);
+        CHECK(captured.lines[0].back() == '\n');
+        CHECK(echo::stats().truncated == 1);
+    }
+
+    SUBCASE("Runtime level filters") {
+        echo::set_level(echo::Level::Warn);
+        CHECK(echo::info("hidden") == echo::Status::Filtered);
+        CHECK(echo::warn("shown") == echo::Status::Ok);
+        CHECK(captured.lines.size() == 1);
+        CHECK(echo::stats().filtered == 1);
+    }
+
+    SUBCASE("Missing writer is reported, not thrown") {
+        echo::set_write_callback(nullptr);
+        CHECK(echo::info("lost") == echo::Status::NoWriter);
+        CHECK(echo::stats().dropped == 1);
+        CHECK(captured.lines.empty());
+    }
+
+    SUBCASE("Lock callbacks wrap each call") {
+        echo::set_lock_callbacks([](void *) { ++lock_depth, ++lock_calls; }, [](void *) { --lock_depth; });
+        lock_calls = 0;
+        echo::info("locked");
+        CHECK(lock_calls == 1);
+        CHECK(lock_depth == 0);
+
+        echo::set_level(echo::Level::Warn);
+        CHECK(echo::info("filtered") == echo::Status::Filtered);
+#ifdef ECHO_FREESTANDING_ATOMIC_FILTERED
+        CHECK(lock_calls == 1); // The level is checked before locking
+#else
+        CHECK(lock_calls == 2); // The filtered counter needs the lock
+#endif
+        CHECK(echo::stats().filtered == 1);
+        echo::set_lock_callbacks(nullptr, nullptr);
+    }
+
+    echo::set_write_callback(nullptr);
+}
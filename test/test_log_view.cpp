@@ -0,0 +1,257 @@
+/**
+ * @file test_log_view.cpp
+ * @brief Test the memory-mapped log view (line index, parsing, search)
+ */
+
+#include <doctest/doctest.h>
+
+#include <echo/utils/log_view.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static fs::path temp_dir() {
+    fs::path dir = fs::temp_directory_path() / "echo_log_view_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+static void write_file(const fs::path &path, const std::string &content) {
+    std::ofstream out(path, std::ios::binary);
+    out << content;
+}
+
+TEST_CASE("find_substring matches std::string_view::find") {
+    std::string text;
+    for (int i = 0; i < 2000; ++i) {
+        text += "line " + std::to_string(i) + " abcabd ";
+    }
+    const std::vector<std::string> needles = {"a", "ab", "abd", "line 1999", "1999 abcabd ", "missing", "d l", "x"};
+    for (const auto &needle : needles) {
+        for (size_t from : {0, 1, 31, 33, 1000}) {
+            const char *hit = echo::detail::find_substring(text.data() + from, text.data() + text.size(), needle);
+            size_t expected = text.find(needle, from);
+            if (expected == std::string::npos) {
+                CHECK(hit == text.data() + text.size());
+            } else {
+                CHECK(static_cast<size_t>(hit - text.data()) == expected);
+            }
+        }
+    }
+    // Match ending exactly at the end of the range
+    std::string tail(100, 'x');
+    tail += "yz";
+    CHECK(echo::detail::find_substring(tail.data(), tail.data() + tail.size(), "yz") == tail.data() + 100);
+    CHECK(echo::detail::count_newlines(text.data(), text.data() + text.size()) == 0);
+}
+
+TEST_CASE("parse_line recognizes echo formats") {
+    auto info = echo::parse_line("[12:00:01][warning] disk almost full");
+    CHECK(info.has_level);
+    CHECK(info.level == echo::Level::Warn);
+    CHECK(info.category.empty());
+    CHECK(info.message == "disk almost full");
+
+    info = echo::parse_line("[error] boom");
+    CHECK(info.level == echo::Level::Error);
+    CHECK(info.message == "boom");
+
+    info = echo::parse_line("[13:05:09.007][info] [net] connected");
+    CHECK(info.level == echo::Level::Info);
+    CHECK(info.category == "net");
+    CHECK(info.message == "connected");
+
+    info = echo::parse_line("\033[38;2;255;0;0m\033[1m[critical]\033[0m [db.pool] exhausted");
+    CHECK(info.level == echo::Level::Critical);
+    CHECK(info.category == "db.pool");
+
+    CHECK_FALSE(echo::parse_line("    at frame 3").has_level);
+    CHECK_FALSE(echo::parse_line("[not a level] text").has_level);
+    CHECK(echo::parse_line("[info] [1, 2, 3] values").category.empty());
+}
+
+TEST_CASE("ViewFilter") {
+    echo::ViewFilter filter;
+    CHECK(filter.matches("[trace] x"));
+
+    filter.min_level = echo::Level::Warn;
+    CHECK_FALSE(filter.matches("[info] x"));
+    CHECK(filter.matches("[error] x"));
+    CHECK(filter.matches("continuation line"));
+
+    filter.category = "net.*";
+    CHECK(filter.matches("[error] [net.http] x"));
+    CHECK_FALSE(filter.matches("[error] [db] x"));
+    CHECK_FALSE(filter.matches("[error] x"));
+    CHECK_FALSE(filter.matches("continuation line"));
+}
+
+TEST_CASE("LogView over a rotation set") {
+    fs::path dir = temp_dir();
+    fs::path base = dir / "app.log";
+
+    // Oldest rotated file first: give them increasing modification times
+    std::string older, old, live;
+    int n = 0;
+    for (int i = 0; i < 3000; ++i, ++n) {
+        older += "[info] [net] line " + std::to_string(n) + "\n";
+    }
+    for (int i = 0; i < 1500; ++i, ++n) {
+        old += (i % 10 == 0 ? "[error] line " : "[debug] line ") + std::to_string(n) + "\n";
+    }
+    for (int i = 0; i < 10; ++i, ++n) {
+        live += "[warning] line " + std::to_string(n) + (i < 9 ? "\n" : ""); // Unterminated last line
+    }
+    write_file(dir / "app.log.2", older);
+    write_file(dir / "app.log.20240101_000000.1", old);
+    write_file(base, live);
+    auto now = fs::file_time_type::clock::now();
+    fs::last_write_time(dir / "app.log.2", now - std::chrono::hours(2));
+    fs::last_write_time(dir / "app.log.20240101_000000.1", now - std::chrono::hours(1));
+    write_file(dir / "other.log", "[info] unrelated\n");
+    for (const char *name : {"app.log.gz", "app.log.lock", "app.log.bak", "app.log.2.gz", "app.log.1x",
+                             "app.log.20240101_000000.1.gz", "app.log.20240101-000000.1"}) {
+        write_file(dir / name, "[info] not rotated\n"); // Not FileSink rotation names
+    }
+
+    auto set = echo::rotation_set(base.string());
+    REQUIRE(set.size() == 3);
+    CHECK(set[0] == (dir / "app.log.2").string());
+    CHECK(set[2] == base.string());
+
+    echo::LogView view;
+    REQUIRE(view.open(set));
+    CHECK(view.size() == older.size() + old.size() + live.size());
+
+    SUBCASE("Navigation works before indexing") {
+        CHECK(view.line(0) == "[info] [net] line 0");
+        CHECK(view.line(view.next_line(0)) == "[info] [net] line 1");
+        // Crossing into the next file
+        uint64_t last_of_first = view.prev_line(older.size());
+        CHECK(view.line(last_of_first) == "[info] [net] line 2999");
+        CHECK(view.next_line(last_of_first) == older.size());
+        CHECK(view.line(view.last_line()) == "[warning] line 4509");
+        CHECK(view.next_line(view.last_line()) == view.size());
+    }
+
+    SUBCASE("Line index") {
+        view.wait_for_index();
+        CHECK(view.index_complete());
+        CHECK(view.indexed_lines() == 4510);
+        for (uint64_t line : {0, 1, 1023, 1024, 2999, 3000, 4095, 4096, 4500, 4509}) {
+            auto offset = view.line_offset(line);
+            REQUIRE(offset);
+            CHECK(view.line(*offset).substr(view.line(*offset).rfind(' ') + 1) == std::to_string(line));
+            CHECK(view.line_number(*offset) == line);
+        }
+        CHECK_FALSE(view.line_offset(4510));
+    }
+
+    SUBCASE("Filtered stepping and search") {
+        echo::ViewFilter errors;
+        errors.min_level = echo::Level::Error;
+        auto first = view.step(0, true, errors);
+        REQUIRE(first);
+        CHECK(view.line(*first) == "[error] line 3000");
+        CHECK(view.line(*view.step(*first, true, errors)) == "[error] line 3010");
+        CHECK_FALSE(view.step(0, true, errors, 100)); // Budget exhausted before the first error
+
+        auto hit = view.find("line 3020", 0, true, &errors);
+        REQUIRE(hit);
+        CHECK(view.line(*hit) == "[error] line 3020");
+        CHECK_FALSE(view.find("line 3021", 0, true, &errors));
+        CHECK(view.find("line 3021", 0, true));
+
+        // Backward search returns the closest match before the position
+        auto back = view.find("[error]", view.size(), false);
+        REQUIRE(back);
+        CHECK(view.line(*back) == "[error] line 4490");
+        back = view.find("[net] line 12", *back, false);
+        REQUIRE(back);
+        CHECK(view.line(*back) == "[info] [net] line 1299");
+        CHECK_FALSE(view.find("[net] line 12", 0, false));
+
+        echo::ViewFilter net;
+        net.category = "net";
+        CHECK_FALSE(view.find("line 3000", 0, true, &net));
+    }
+
+    SUBCASE("Bounded searches resume to the same result") {
+        echo::ViewFilter errors;
+        errors.min_level = echo::Level::Error;
+        struct Query {
+            const char *needle;
+            uint64_t from;
+            bool forward;
+            const echo::ViewFilter *filter;
+        };
+        for (const Query &q : {Query{"line 3020", 0, true, &errors}, Query{"line 3021", 0, true, &errors},
+                               Query{"line 4509", 0, true, nullptr}, Query{"[error]", view.size(), false, nullptr},
+                               Query{"[net] line 12", older.size() + 10, false, nullptr},
+                               Query{"[net] line 12", 0, false, nullptr}}) {
+            for (uint64_t budget : {7, 4096, 1 << 20}) {
+                uint64_t from = q.from;
+                int steps = 0;
+                echo::LogView::FindProgress step;
+                while (true) {
+                    step = view.find_some(q.needle, from, q.forward, q.filter, budget);
+                    ++steps;
+                    if (step.match || step.done) {
+                        break;
+                    }
+                    from = step.resume;
+                }
+                CHECK(step.match == view.find(q.needle, q.from, q.forward, q.filter));
+                if (budget == 7 && (q.forward || q.from > 0)) {
+                    CHECK(steps > 1); // Really resumed
+                }
+            }
+        }
+    }
+
+    view.close();
+    fs::remove_all(dir);
+}
+
+TEST_CASE("LogView over large input indexes in the background") {
+    fs::path dir = temp_dir();
+    fs::path path = dir / "big.log";
+    {
+        std::ofstream out(path, std::ios::binary);
+        std::string line;
+        for (int i = 0; i < 400000; ++i) {
+            line = "[12:00:00][info] request " + std::to_string(i) + " served\n";
+            out << line;
+        }
+    }
+
+    echo::LogView view;
+    REQUIRE(view.open({path.string()}));
+    view.start_indexing();
+    // Browsable while indexing
+    CHECK(view.line(0) == "[12:00:00][info] request 0 served");
+    view.wait_for_index();
+    CHECK(view.indexed_lines() == 400000);
+    auto offset = view.line_offset(399999);
+    REQUIRE(offset);
+    CHECK(view.line(*offset) == "[12:00:00][info] request 399999 served");
+    auto hit = view.find("request 250000 ", 0, true);
+    REQUIRE(hit);
+    CHECK(view.line_number(*hit) == 250000);
+
+    view.close();
+    fs::remove_all(dir);
+}
+
+TEST_CASE("LogView reports open errors") {
+    echo::LogView view;
+    CHECK_FALSE(view.open({"/nonexistent/echo_view.log"}));
+    CHECK(view.error().find("/nonexistent/echo_view.log") != std::string::npos);
+    CHECK(view.empty());
+}
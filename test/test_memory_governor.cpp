@@ -0,0 +1,273 @@
+/**
+ * @file test_memory_governor.cpp
+ * @brief Test the memory governor against stand-in cgroup v2 memory files
+ */
+
+#include <doctest/doctest.h>
+
+#define ECHO_ENABLE_NETWORK_SINK
+#define ECHO_ENABLE_RELIABLE_UDP_SINK
+#include <echo/echo.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Sink that records every formatted message and the last memory budget
+class BudgetSink : public echo::Sink {
+  private:
+    std::vector<std::string> messages_;
+    double scale_ = 1.0;
+    mutable std::mutex mutex_;
+
+  public:
+    void write(echo::Level level, const std::string &message) override {
+        if (!should_log(level)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        messages_.push_back(message);
+    }
+
+    void flush() override {}
+
+    void set_memory_budget(double scale) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        scale_ = scale;
+    }
+
+    [[nodiscard]] double scale() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return scale_;
+    }
+
+    [[nodiscard]] std::vector<std::string> messages() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_;
+    }
+};
+
+// Counts how often it is converted
+struct Converted {
+    static inline int conversions = 0;
+    std::string to_string() const {
+        ++conversions;
+        return "converted";
+    }
+};
+
+// Directory standing in for a cgroup, with a 1000-byte memory.max
+class FakeCgroup {
+  private:
+    fs::path dir_;
+
+    void write(const char *name, const std::string &content) const {
+        std::ofstream out(dir_ / name, std::ios::binary | std::ios::trunc);
+        out << content;
+    }
+
+  public:
+    FakeCgroup() : dir_(fs::temp_directory_path() / "echo_memory_governor_test") {
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+        write("memory.high", "max\n");
+        write("memory.max", "1000\n");
+        set(0.0, 0.0, 700);
+    }
+
+    ~FakeCgroup() { fs::remove_all(dir_); }
+
+    void set(double some_avg10, double full_avg10, uint64_t current) const {
+        write("memory.pressure", "some avg10=" + std::to_string(some_avg10) +
+                                     " avg60=0.00 avg300=0.00 total=12345\nfull avg10=" +
+                                     std::to_string(full_avg10) + " avg60=0.00 avg300=0.00 total=678\n");
+        write("memory.current", std::to_string(current) + "\n");
+    }
+
+    [[nodiscard]] std::string path() const { return dir_.string(); }
+};
+
+TEST_CASE("Memory sample parsing") {
+    FakeCgroup cgroup;
+    cgroup.set(12.5, 3.25, 900);
+    auto sample = echo::detail::read_memory_sample(cgroup.path());
+    CHECK(sample.valid);
+    CHECK(sample.some_avg10 == 12.5);
+    CHECK(sample.full_avg10 == 3.25);
+    CHECK(sample.current == 900);
+    CHECK(sample.limit == 1000);
+    CHECK(sample.usage() == 0.9);
+
+    CHECK_FALSE(echo::detail::read_memory_sample("/nonexistent/echo_cgroup").valid);
+    CHECK(echo::detail::read_memory_sample("/nonexistent/echo_cgroup").limit == 0);
+}
+
+TEST_CASE("Memory governor transitions") {
+    echo::set_level(echo::Level::Trace);
+    echo::clear_category_levels();
+    echo::clear_sinks();
+    auto sink = std::make_shared<BudgetSink>();
+    echo::add_sink(sink);
+
+    FakeCgroup cgroup;
+    echo::MemoryGovernorOptions options;
+    options.cgroup_dir = cgroup.path();
+    options.recovery_samples = 2;
+    std::vector<echo::MemoryTransition> seen;
+
+    {
+        echo::MemoryGovernor governor(options);
+        governor.set_transition_callback([&](const echo::MemoryTransition &t) { seen.push_back(t); });
+
+        // 70% of the limit, no stalls: configured budgets
+        CHECK(governor.poll() == echo::MemoryPressure::Normal);
+        CHECK(sink->scale() == 1.0);
+        CHECK(seen.empty());
+
+        SUBCASE("Escalation is immediate, shedding follows the state") {
+            cgroup.set(15.0, 0.0, 700);
+            CHECK(governor.poll() == echo::MemoryPressure::Elevated);
+            CHECK(sink->scale() == 0.5);
+            Converted::conversions = 0;
+            echo::debug("shed debug ", Converted{});
+            echo::info("kept info");
+            echo::set_category_level("net", echo::Level::Trace);
+            echo::category("net").debug("shed category debug ", Converted{});
+            CHECK(Converted::conversions == 0); // Shed before the message is built
+            CHECK(echo::get_level() == echo::Level::Trace); // The user's level is unchanged
+
+            cgroup.set(0.0, 0.0, 990);
+            CHECK(governor.poll() == echo::MemoryPressure::Critical);
+            CHECK(sink->scale() == 0.125);
+            echo::info("shed info");
+            echo::warn("kept warn");
+
+            auto messages = sink->messages();
+            REQUIRE(messages.size() == 2);
+            CHECK(messages[0].find("kept info") != std::string::npos);
+            CHECK(messages[1].find("kept warn") != std::string::npos);
+
+            // Sinks added under pressure get the current budget
+            auto late = std::make_shared<BudgetSink>();
+            echo::add_sink(late);
+            CHECK(late->scale() == 0.125);
+
+            auto stats = governor.stats();
+            CHECK(stats.state == echo::MemoryPressure::Critical);
+            CHECK(stats.shed_level == echo::Level::Warn);
+            CHECK(stats.escalations == 2);
+            CHECK(stats.relaxations == 0);
+            REQUIRE(stats.transitions.size() == 2);
+            CHECK(stats.transitions[1].from == echo::MemoryPressure::Elevated);
+            CHECK(stats.transitions[1].to == echo::MemoryPressure::Critical);
+            CHECK(stats.transitions[1].sample.current == 990);
+            CHECK(seen.size() == 2);
+        }
+
+        SUBCASE("Relaxing needs consecutive samples") {
+            cgroup.set(50.0, 0.0, 700);
+            CHECK(governor.poll() == echo::MemoryPressure::Critical);
+
+            cgroup.set(12.0, 0.0, 700);
+            CHECK(governor.poll() == echo::MemoryPressure::Critical);
+            cgroup.set(0.0, 0.0, 100);
+            CHECK(governor.poll() == echo::MemoryPressure::Elevated); // Highest state seen while recovering
+            CHECK(governor.poll() == echo::MemoryPressure::Elevated);
+            cgroup.set(50.0, 0.0, 100);
+            CHECK(governor.poll() == echo::MemoryPressure::Critical); // A spike restarts the recovery
+            cgroup.set(0.0, 0.0, 100);
+            CHECK(governor.poll() == echo::MemoryPressure::Critical);
+            CHECK(governor.poll() == echo::MemoryPressure::Low);
+            CHECK(sink->scale() == 2.0);
+            CHECK(echo::detail::get_effective_level() == echo::Level::Trace);
+
+            auto stats = governor.stats();
+            CHECK(stats.escalations == 2);
+            CHECK(stats.relaxations == 2);
+            CHECK(stats.samples == 8);
+            CHECK(stats.last.current == 100);
+        }
+
+        SUBCASE("Full stalls alone are critical") {
+            cgroup.set(5.0, 20.0, 500);
+            CHECK(governor.poll() == echo::MemoryPressure::Critical);
+        }
+    }
+
+    // Destroying the governor restores budgets and levels
+    CHECK(sink->scale() == 1.0);
+    CHECK(echo::detail::get_effective_level() == echo::Level::Trace);
+
+    echo::clear_category_levels();
+    echo::clear_sinks();
+}
+
+TEST_CASE("Memory governor without memory files stays normal") {
+    echo::MemoryGovernorOptions options;
+    options.cgroup_dir = "/nonexistent/echo_cgroup";
+    echo::MemoryGovernor governor(options);
+    CHECK(governor.poll() == echo::MemoryPressure::Normal);
+    CHECK(governor.stats().read_errors == 1);
+}
+
+TEST_CASE("Memory governor background thread") {
+    echo::clear_sinks();
+    auto sink = std::make_shared<BudgetSink>();
+    echo::add_sink(sink);
+
+    FakeCgroup cgroup;
+    cgroup.set(60.0, 0.0, 700);
+    echo::MemoryGovernorOptions options;
+    options.cgroup_dir = cgroup.path();
+    options.interval = std::chrono::milliseconds(5);
+    echo::MemoryGovernor governor(options);
+    governor.start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (governor.state() != echo::MemoryPressure::Critical && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(governor.state() == echo::MemoryPressure::Critical);
+    governor.stop();
+    CHECK(governor.state() == echo::MemoryPressure::Normal);
+    CHECK(sink->scale() == 1.0);
+
+    echo::clear_sinks();
+}
+
+TEST_CASE("Sink buffers follow the memory budget") {
+    SUBCASE("Network sink drops the oldest buffered messages") {
+        echo::NetworkSink net("127.0.0.1", 1); // Nothing listens: every write is buffered
+        net.set_buffer_size(100);
+        for (int i = 0; i < 100; ++i) {
+            net.write(echo::Level::Info, "message " + std::to_string(i) + "\n");
+        }
+        CHECK(net.get_buffer_count() == 100);
+
+        net.set_memory_budget(0.125);
+        CHECK(net.get_buffer_limit() == 12);
+        CHECK(net.get_buffer_count() == 12);
+
+        net.set_memory_budget(2.0);
+        CHECK(net.get_buffer_limit() == 200);
+        net.set_buffer_size(0); // Buffering disabled stays disabled
+        CHECK(net.get_buffer_limit() == 0);
+    }
+
+#ifdef __unix__
+    SUBCASE("Reliable UDP window") {
+        echo::ReliableUdpSink udp("127.0.0.1", 9);
+        udp.set_window_size(1024);
+        udp.set_memory_budget(0.125);
+        CHECK(udp.window_size() == 128);
+        udp.set_memory_budget(0.0001);
+        CHECK(udp.window_size() == 1);
+        udp.set_memory_budget(1.0);
+        CHECK(udp.window_size() == 1024);
+    }
+#endif
+}
@@ -0,0 +1,265 @@
+/**
+ * @file test_metrics.cpp
+ * @brief Test aggregation of structured fields into metrics
+ */
+
+#include <doctest/doctest.h>
+
+#include <echo/echo.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Sink that records every formatted message
+class RecordingSink : public echo::Sink {
+  private:
+    std::vector<std::string> messages_;
+    mutable std::mutex mutex_;
+
+  public:
+    void write(echo::Level level, const std::string &message) override {
+        if (!should_log(level)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        messages_.push_back(message);
+    }
+
+    void flush() override {}
+
+    [[nodiscard]] std::vector<std::string> messages() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_;
+    }
+};
+
+static bool contains(const std::string &haystack, const std::string &needle) {
+    return haystack.find(needle) != std::string::npos;
+}
+
+TEST_CASE("Metrics from structured fields") {
+    echo::set_level(echo::Level::Trace);
+    echo::clear_category_levels();
+    echo::clear_metric_rules();
+    echo::set_metrics_options({});
+    echo::clear_sinks();
+    auto sink = std::make_shared<RecordingSink>();
+    echo::add_sink(sink);
+
+    SUBCASE("Counters, sums, gauges and histograms") {
+        echo::MetricRule rule;
+        rule.name = "http";
+        rule.category = "http";
+        rule.count_by = {"status"};
+        rule.sums = {"bytes"};
+        rule.gauges = {"queue"};
+        rule.histograms = {{"ms", {100, 10, 1}}};
+        echo::add_metric_rule(rule);
+
+        echo::category("http").info(echo::kv("status", 200, "bytes", 100, "ms", 0.5, "queue", 3));
+        echo::category("http").info(echo::kv("status", 200, "bytes", 50, "ms", 7, "queue", 5));
+        echo::category("http").warn(echo::kv("status", 503, "bytes", 0, "ms", 250));
+        echo::category("db").info(echo::kv("status", 200, "bytes", 1000));
+
+        auto snapshot = echo::metrics_snapshot();
+        REQUIRE(snapshot.size() == 1);
+        const auto &http = snapshot[0];
+        CHECK(http.name == "http");
+        CHECK(http.records == 3);
+        CHECK(http.dropped == 0);
+        CHECK(http.counters.at("status").at("200") == 2);
+        CHECK(http.counters.at("status").at("503") == 1);
+        CHECK(http.sums.at("bytes") == 150.0);
+        CHECK(http.gauges.at("queue") == 5.0);
+
+        const auto &ms = http.histograms.at("ms");
+        CHECK(ms.bounds == std::vector<double>{1, 10, 100});
+        CHECK(ms.buckets == std::vector<uint64_t>{1, 1, 0, 1});
+        CHECK(ms.count == 3);
+        CHECK(ms.min == 0.5);
+        CHECK(ms.max == 250.0);
+
+        // Originals are still written when not dropped
+        CHECK(sink->messages().size() == 4);
+    }
+
+    SUBCASE("Dropped originals cost no sink writes") {
+        echo::MetricRule rule;
+        rule.name = "hits";
+        rule.prefix = "cache ";
+        rule.count_by = {"result"};
+        rule.drop_original = true;
+        echo::add_metric_rule(rule);
+
+        for (int i = 0; i < 100; ++i) {
+            echo::debug("cache ", echo::kv("result", i % 4 == 0 ? "miss" : "hit"));
+        }
+        echo::info("unrelated result=hit");
+
+        auto messages = sink->messages();
+        REQUIRE(messages.size() == 1);
+        CHECK(contains(messages[0], "unrelated"));
+
+        auto snapshot = echo::metrics_snapshot();
+        CHECK(snapshot[0].records == 100);
+        CHECK(snapshot[0].dropped == 100);
+        CHECK(snapshot[0].counters.at("result").at("hit") == 75);
+        CHECK(snapshot[0].counters.at("result").at("miss") == 25);
+    }
+
+    SUBCASE("Block lines are observed like single records") {
+        echo::MetricRule rule;
+        rule.name = "hits";
+        rule.prefix = "cache ";
+        rule.count_by = {"result"};
+        rule.drop_original = true;
+        echo::add_metric_rule(rule);
+
+        echo::block()
+            .info("request done")
+            .debug("cache ", echo::kv("result", "hit"))
+            .debug("cache ", echo::kv("result", "miss"));
+
+        auto messages = sink->messages();
+        REQUIRE(messages.size() == 1);
+        CHECK(contains(messages[0], "request done"));
+        CHECK_FALSE(contains(messages[0], "cache"));
+
+        auto snapshot = echo::metrics_snapshot();
+        CHECK(snapshot[0].records == 2);
+        CHECK(snapshot[0].counters.at("result").at("hit") == 1);
+        CHECK(snapshot[0].counters.at("result").at("miss") == 1);
+    }
+
+    SUBCASE("Non-numeric values are ignored by numeric aggregates") {
+        echo::MetricRule rule;
+        rule.name = "n";
+        rule.sums = {"v"};
+        echo::add_metric_rule(rule);
+
+        echo::info(echo::kv("v", "abc"));
+        echo::info(echo::kv("v", "12x"));
+        echo::info("no fields at all");
+
+        auto snapshot = echo::metrics_snapshot();
+        CHECK(snapshot[0].records == 3);
+        CHECK(snapshot[0].sums.empty());
+
+        echo::info(echo::kv("v", 2.5), " ", echo::kv("v2", 1));
+        CHECK(echo::metrics_snapshot()[0].sums.at("v") == 2.5);
+    }
+
+    SUBCASE("Quoted values with spaces stay one field") {
+        echo::MetricRule rule;
+        rule.name = "errors";
+        rule.count_by = {"reason"};
+        rule.sums = {"ms"};
+        echo::add_metric_rule(rule);
+
+        echo::info(echo::kv_quoted("reason", "timed out", "ms", 30));
+        echo::info(echo::kv_quoted("reason", "timed out", "ms", 12));
+        echo::info(echo::kv_quoted("reason", "say \"hi\"", "ms", 1));
+        echo::info("reason=\"unterminated ms=5");
+
+        auto snapshot = echo::metrics_snapshot();
+        CHECK(snapshot[0].counters.at("reason").at("timed out") == 2);
+        CHECK(snapshot[0].counters.at("reason").at("say \\\"hi\\\"") == 1);
+        CHECK(snapshot[0].counters.at("reason").at("unterminated ms=5") == 1);
+        CHECK(snapshot[0].sums.at("ms") == 43);
+    }
+
+    SUBCASE("Per-thread aggregates are merged, including from exited threads") {
+        echo::MetricRule rule;
+        rule.name = "work";
+        rule.category = "worker.*";
+        rule.sums = {"items"};
+        rule.drop_original = true;
+        echo::add_metric_rule(rule);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([] {
+                for (int i = 0; i < 1000; ++i) {
+                    echo::category("worker.pool").info(echo::kv("items", 2));
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        auto snapshot = echo::metrics_snapshot();
+        CHECK(snapshot[0].records == 4000);
+        CHECK(snapshot[0].sums.at("items") == 8000.0);
+        CHECK(sink->messages().empty());
+    }
+
+    SUBCASE("emit_metrics writes one summary per rule and resets") {
+        echo::MetricRule rule;
+        rule.name = "http";
+        rule.count_by = {"status"};
+        rule.sums = {"bytes"};
+        rule.histograms = {{"ms", {10}}};
+        rule.drop_original = true;
+        echo::add_metric_rule(rule);
+
+        echo::info(echo::kv("status", 200, "bytes", 10, "ms", 5));
+        echo::info(echo::kv("status", 404, "bytes", 20, "ms", 50));
+        echo::emit_metrics();
+
+        auto messages = sink->messages();
+        REQUIRE(messages.size() == 1);
+        CHECK(contains(messages[0], "[metrics] http records=2 dropped=2"));
+        CHECK(contains(messages[0], "status.200=1"));
+        CHECK(contains(messages[0], "status.404=1"));
+        CHECK(contains(messages[0], "bytes.sum=30"));
+        CHECK(contains(messages[0], "ms.le_10=1"));
+        CHECK(contains(messages[0], "ms.le_inf=2"));
+
+        CHECK(echo::metrics_snapshot()[0].records == 0);
+        echo::emit_metrics(); // Nothing matched since: no record
+        CHECK(sink->messages().size() == 1);
+    }
+
+    SUBCASE("Periodic summaries") {
+        echo::MetricRule rule;
+        rule.name = "tick";
+        rule.drop_original = true;
+        echo::add_metric_rule(rule);
+        echo::set_metrics_options({.interval = std::chrono::milliseconds(20), .level = echo::Level::Warn});
+
+        echo::info("t=1");
+        CHECK(sink->messages().empty());
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        echo::info("t=2");
+
+        auto messages = sink->messages();
+        REQUIRE(messages.size() == 1);
+        CHECK(contains(messages[0], "[warning]"));
+        CHECK(contains(messages[0], "tick records=2"));
+    }
+
+    SUBCASE("Filtered records are not counted; clearing rules restores output") {
+        echo::MetricRule rule;
+        rule.name = "all";
+        rule.drop_original = true;
+        echo::add_metric_rule(rule);
+
+        echo::set_category_level("quiet", echo::Level::Error);
+        echo::category("quiet").info("x=1");
+        CHECK(echo::metrics_snapshot()[0].records == 0);
+
+        echo::clear_metric_rules();
+        CHECK(echo::metrics_snapshot().empty());
+        echo::info("x=1");
+        CHECK(sink->messages().size() == 1);
+    }
+
+    echo::clear_metric_rules();
+    echo::set_metrics_options({});
+    echo::clear_category_levels();
+    echo::clear_sinks();
+}
@@ -0,0 +1,286 @@
+/**
+ * @file test_reliable_udp.cpp
+ * @brief Test the reliable UDP transport over localhost with injected packet loss
+ */
+
+#include <doctest/doctest.h>
+
+#define ECHO_ENABLE_RELIABLE_UDP_SINK
+#include <echo/echo.hpp>
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+struct Collector {
+    std::vector<std::string> messages;
+    std::vector<uint64_t> seqs;
+    std::vector<std::pair<uint64_t, uint64_t>> gaps;
+
+    void attach(echo::ReliableUdpReceiver &receiver) {
+        receiver.on_record([this](const echo::ReceivedRecord &r) {
+            messages.emplace_back(r.message);
+            seqs.push_back(r.seq);
+        });
+        receiver.on_gap([this](uint64_t, uint64_t first, uint64_t last) { gaps.emplace_back(first, last); });
+    }
+};
+
+// Alternate between receiver and sender until the receiver has nothing left to wait for
+static void pump(echo::ReliableUdpReceiver &receiver, echo::ReliableUdpSink &sink, int rounds = 50) {
+    for (int i = 0; i < rounds; ++i) {
+        receiver.poll(5ms);
+        sink.service();
+    }
+}
+
+TEST_CASE("ReliableUdpSink and ReliableUdpReceiver") {
+    echo::ReliableUdpReceiver receiver;
+    REQUIRE(receiver.is_open());
+    receiver.set_nack_interval(5ms);
+
+    Collector collector;
+    collector.attach(receiver);
+
+    echo::ReliableUdpSink sink("127.0.0.1", receiver.port());
+    REQUIRE(sink.healthy());
+    sink.set_linger(0us); // One record per datagram
+
+    SUBCASE("Lossless delivery is in order") {
+        for (int i = 0; i < 20; ++i) {
+            sink.write(echo::Level::Info, "msg " + std::to_string(i));
+        }
+        sink.flush();
+        pump(receiver, sink, 5);
+
+        REQUIRE(collector.messages.size() == 20);
+        for (int i = 0; i < 20; ++i) {
+            CHECK(collector.messages[i] == "msg " + std::to_string(i));
+        }
+        CHECK(collector.gaps.empty());
+        CHECK(receiver.stats().lost == 0);
+        CHECK(sink.stats().retransmits == 0);
+    }
+
+    SUBCASE("Dropped datagrams are NACKed and retransmitted") {
+        const std::set<uint64_t> dropped = {3, 7, 8, 15};
+        sink.set_drop_injector([&](uint64_t seq, bool retransmit) { return !retransmit && dropped.count(seq) > 0; });
+
+        for (int i = 0; i < 20; ++i) {
+            sink.write(echo::Level::Info, "msg " + std::to_string(i));
+        }
+        sink.flush();
+        pump(receiver, sink);
+
+        REQUIRE(collector.messages.size() == 20);
+        for (int i = 0; i < 20; ++i) {
+            CHECK(collector.messages[i] == "msg " + std::to_string(i));
+        }
+        CHECK(collector.gaps.empty());
+        CHECK(sink.stats().retransmits == dropped.size());
+        CHECK(receiver.stats().recovered == dropped.size());
+        CHECK(receiver.stats().nacks_sent > 0);
+    }
+
+    SUBCASE("Lost tail is recovered through the flush heartbeat") {
+        sink.set_drop_injector([](uint64_t seq, bool retransmit) { return !retransmit && seq >= 4; });
+
+        for (int i = 0; i < 6; ++i) {
+            sink.write(echo::Level::Info, "msg " + std::to_string(i));
+        }
+        sink.flush();
+        pump(receiver, sink);
+
+        CHECK(collector.messages.size() == 6);
+        CHECK(collector.gaps.empty());
+    }
+
+    SUBCASE("Housekeeping sends a lingering batch and heartbeats a lost tail") {
+        sink.set_linger(5ms);
+        sink.set_heartbeat_interval(20ms);
+        sink.set_drop_injector([](uint64_t, bool retransmit) { return !retransmit; }); // Every first send is lost
+
+        for (int i = 0; i < 3; ++i) {
+            sink.write(echo::Level::Info, "msg " + std::to_string(i));
+        }
+        // No flush() or service(): only the housekeeping thread can send the batch and the heartbeat
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (collector.messages.size() < 3 && std::chrono::steady_clock::now() < deadline) {
+            receiver.poll(5ms);
+        }
+
+        CHECK(collector.messages.size() == 3);
+        CHECK(sink.stats().datagrams == 1);
+        CHECK(sink.stats().retransmits >= 1);
+    }
+
+    SUBCASE("Missing datagrams beyond one NACK's ranges keep their attempts") {
+        // Every other datagram is lost once: one more single-seq range than a NACK holds
+        const uint64_t ranges = echo::detail::RUDP_MAX_NACK_RANGES + 1;
+        sink.set_drop_injector([](uint64_t seq, bool retransmit) { return !retransmit && seq % 2 == 0; });
+        receiver.set_max_nack_attempts(1);
+
+        for (uint64_t i = 0; i < 2 * ranges + 1; ++i) {
+            sink.write(echo::Level::Info, "msg " + std::to_string(i));
+        }
+        sink.flush();
+        pump(receiver, sink);
+
+        CHECK(collector.gaps.empty());
+        CHECK(collector.messages.size() == 2 * ranges + 1);
+        CHECK(receiver.stats().recovered == ranges);
+    }
+
+    SUBCASE("Records with an invalid level are dropped") {
+        std::string datagram;
+        echo::detail::rudp_put_header(datagram, echo::detail::RUDP_DATA, 2, 43, 1);
+        datagram += static_cast<char>(200);
+        echo::detail::rudp_put_u32(datagram, 3);
+        datagram += "bad";
+        datagram += static_cast<char>(echo::Level::Critical);
+        echo::detail::rudp_put_u32(datagram, 4);
+        datagram += "good";
+
+        int raw = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(receiver.port());
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        ::sendto(raw, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        ::close(raw);
+        pump(receiver, sink, 5);
+
+        REQUIRE(collector.messages.size() == 1);
+        CHECK(collector.messages[0] == "good");
+        CHECK(receiver.stats().malformed == 1);
+    }
+
+    SUBCASE("Datagrams evicted from the window are reported as a gap") {
+        sink.set_window_size(2);
+        sink.set_drop_injector([](uint64_t seq, bool) { return seq == 2; });
+        receiver.set_max_nack_attempts(2);
+
+        for (int i = 0; i < 10; ++i) {
+            sink.write(echo::Level::Info, "msg " + std::to_string(i));
+        }
+        sink.flush();
+        pump(receiver, sink);
+
+        REQUIRE(collector.gaps.size() == 1);
+        CHECK(collector.gaps[0] == std::make_pair<uint64_t, uint64_t>(2, 2));
+        CHECK(collector.messages.size() == 9);
+        CHECK(collector.messages[1] == "msg 2");
+        CHECK(receiver.stats().lost == 1);
+        CHECK(sink.stats().unrecoverable > 0);
+    }
+
+    SUBCASE("Duplicates are dropped") {
+        // Hand-built datagram, sent twice from a raw socket
+        std::string datagram;
+        echo::detail::rudp_put_header(datagram, echo::detail::RUDP_DATA, 1, 42, 1);
+        datagram += static_cast<char>(echo::Level::Warn);
+        echo::detail::rudp_put_u32(datagram, 3);
+        datagram += "dup";
+
+        int raw = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(receiver.port());
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        for (int i = 0; i < 2; ++i) {
+            ::sendto(raw, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        }
+        ::close(raw);
+        pump(receiver, sink, 5);
+
+        REQUIRE(collector.messages.size() == 1);
+        CHECK(collector.messages[0] == "dup");
+        CHECK(receiver.stats().duplicates == 1);
+    }
+
+    SUBCASE("Each sender is its own stream") {
+        sink.write(echo::Level::Info, "first");
+        sink.flush();
+
+        echo::ReliableUdpSink other("127.0.0.1", receiver.port());
+        other.set_linger(0us);
+        other.write(echo::Level::Warn, "second");
+        other.flush();
+        pump(receiver, other, 5);
+
+        CHECK(collector.messages.size() == 2);
+        CHECK(collector.gaps.empty());
+        CHECK(sink.stream_id() != other.stream_id());
+    }
+
+    SUBCASE("Records are batched into datagrams") {
+        sink.set_linger(std::chrono::seconds(10));
+        sink.set_max_datagram_size(200);
+        for (int i = 0; i < 30; ++i) {
+            sink.write(echo::Level::Debug, "batched record " + std::to_string(i));
+        }
+        sink.flush();
+        pump(receiver, sink, 5);
+
+        CHECK(collector.messages.size() == 30);
+        CHECK(sink.stats().records == 30);
+        CHECK(sink.stats().datagrams < 30);
+        CHECK(collector.seqs.front() == collector.seqs[1]); // same datagram
+    }
+
+    SUBCASE("ANSI codes are stripped") {
+        sink.write(echo::Level::Error, "\033[31mred\033[0m");
+        sink.flush();
+        pump(receiver, sink, 5);
+
+        REQUIRE(collector.messages.size() == 1);
+        CHECK(collector.messages[0] == "red");
+    }
+}
+
+TEST_CASE("ReliableUdpSink clamps NACK ranges to what it still holds") {
+    // A bare socket stands in for the receiver so the test can send any NACK
+    int peer = ::socket(AF_INET, SOCK_DGRAM, 0);
+    REQUIRE(peer != -1);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    REQUIRE(::bind(peer, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    socklen_t len = sizeof(addr);
+    REQUIRE(::getsockname(peer, reinterpret_cast<sockaddr *>(&addr), &len) == 0);
+
+    echo::ReliableUdpSink sink("127.0.0.1", ntohs(addr.sin_port));
+    REQUIRE(sink.healthy());
+    sink.set_linger(0us);
+    sink.set_window_size(4);
+    for (int i = 0; i < 10; ++i) {
+        sink.write(echo::Level::Info, "msg " + std::to_string(i));
+    }
+    sink.flush();
+
+    char buffer[2048];
+    sockaddr_in sender{};
+    socklen_t sender_len = sizeof(sender);
+    REQUIRE(::recvfrom(peer, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr *>(&sender), &sender_len) > 0);
+
+    // One range covering every sequence number, as a stale or bogus NACK could
+    std::string nack;
+    echo::detail::rudp_put_header(nack, echo::detail::RUDP_NACK, 1, sink.stream_id(), 0);
+    echo::detail::rudp_put_u64(nack, 0);
+    echo::detail::rudp_put_u64(nack, UINT64_MAX);
+    ::sendto(peer, nack.data(), nack.size(), 0, reinterpret_cast<sockaddr *>(&sender), sender_len);
+    for (int i = 0; i < 50 && sink.stats().nacks_received == 0; ++i) {
+        std::this_thread::sleep_for(1ms);
+        sink.service();
+    }
+    ::close(peer);
+
+    CHECK(sink.stats().nacks_received == 1);
+    CHECK(sink.stats().unrecoverable == 6); // Seqs 1-6 were evicted
+    CHECK(sink.stats().retransmits == 4);   // Seqs 7-10 are still in the window
+}
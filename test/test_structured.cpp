@@ -56,6 +56,14 @@ TEST_CASE("kv() with different types") {
     }
 }
 
+TEST_CASE("kv_quoted() quotes values with spaces or quotes") {
+    CHECK(echo::kv_quoted("reason", "timed out") == "reason=\"timed out\"");
+    CHECK(echo::kv_quoted("q", "say \"hi\"", "path", "a\\b") == "q=\"say \\\"hi\\\"\" path=a\\b");
+    CHECK(echo::kv_quoted("empty", "", "n", 5) == "empty= n=5");
+    // kv() itself never quotes
+    CHECK(echo::kv("reason", "timed out", "q", "\"hi\"") == "reason=timed out q=\"hi\"");
+}
+
 TEST_CASE("kv() with multiple pairs") {
     SUBCASE("Single pair") {
         std::string result = echo::kv("key", "value");
@@ -0,0 +1,98 @@
+/**
+ * @file test_warmup.cpp
+ * @brief Test explicit warm-up of lazily initialized state
+ */
+
+#include <doctest/doctest.h>
+
+#include <echo/echo.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Sink that records warm-up calls and writes
+class WarmUpTestSink : public echo::Sink {
+  private:
+    std::vector<std::string> messages_;
+    mutable std::mutex mutex_;
+
+  public:
+    std::atomic<int> warm_ups{0};
+
+    void write(echo::Level level, const std::string &message) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        messages_.push_back(message);
+    }
+
+    void flush() override {}
+
+    void warm_up() override { ++warm_ups; }
+
+    [[nodiscard]] size_t message_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_.size();
+    }
+};
+
+TEST_CASE("Warm-up") {
+    SUBCASE("warm_up creates the default sink without logging") {
+        // First thing in this process: the registry has not been touched yet
+        echo::warm_up();
+        CHECK(echo::sink_count() == 1);
+    }
+
+    SUBCASE("warm_up calls Sink::warm_up on registered sinks and writes nothing") {
+        echo::clear_sinks();
+        auto sink = std::make_shared<WarmUpTestSink>();
+        echo::add_sink(sink);
+
+        echo::warm_up();
+        CHECK(sink->warm_ups == 1);
+        CHECK(sink->message_count() == 0);
+
+        echo::info("after warm-up");
+        CHECK(sink->message_count() == 1);
+    }
+
+    SUBCASE("warm_up pre-sizes the rate limit tables") {
+        echo::warm_up(4096);
+        CHECK(echo::detail::get_once_set().bucket_count() >= 4096);
+        CHECK(echo::detail::get_every_map().bucket_count() >= 4096);
+    }
+
+    SUBCASE("thread_warm_up reserves the per-thread buffer") {
+        echo::clear_sinks();
+        auto sink = std::make_shared<WarmUpTestSink>();
+        echo::add_sink(sink);
+
+        size_t capacity = 0;
+        size_t capacity_after_log = 0;
+        std::thread worker([&] {
+            echo::thread_warm_up(8192);
+            capacity = echo::detail::thread_format_buffer().capacity();
+            echo::info("from worker");
+            capacity_after_log = echo::detail::thread_format_buffer().capacity();
+        });
+        worker.join();
+
+        CHECK(capacity >= 8192);
+        CHECK(capacity_after_log == capacity);
+        CHECK(sink->message_count() == 1);
+    }
+
+    SUBCASE("Repeated warm-up is harmless") {
+        echo::clear_sinks();
+        auto sink = std::make_shared<WarmUpTestSink>();
+        echo::add_sink(sink);
+
+        echo::warm_up();
+        echo::warm_up();
+        echo::thread_warm_up();
+        echo::thread_warm_up(16);
+        CHECK(sink->warm_ups == 2);
+        CHECK(echo::detail::thread_format_buffer().capacity() >= echo::detail::WARM_UP_BUFFER_SIZE);
+        CHECK(echo::detail::thread_format_buffer().empty());
+    }
+}
@@ -0,0 +1,632 @@
+/**
+ * @file echo-view.cpp
+ * @brief Terminal viewer for echo log files
+ *
+ * Maps the files instead of reading them, so opening a multi-GB log (or a
+ * whole rotation set with --rotated) is immediate; line numbers fill in as
+ * the background index progresses. Lines are filtered by level and category
+ * as echo writes them, and searched with the SIMD kernel of utils/log_view.hpp.
+ *
+ * Usage: echo-view [options] FILE...
+ *   -r, --rotated          Also open rotated siblings of each FILE (oldest first)
+ *   -l, --level LEVEL      Hide lines below LEVEL (trace..critical)
+ *   -c, --category PAT     Only lines of category PAT ("net", "app.*")
+ *   -g, --grep TEXT        Only lines containing TEXT (interactive: initial search)
+ *   -p, --print            Print matching lines instead of the interactive view
+ *   -n, --line-numbers     Prefix printed lines with their line number
+ *
+ * Keys: j/k or arrows scroll, space/b page, g/G top/bottom, left/right shift,
+ *       / ? search forward/backward (Esc cancels), n/N repeat, : go to line,
+ *       l cycle minimum level, c set category, q quit
+ */
+
+#include <echo/utils/color.hpp>
+#include <echo/utils/log_view.hpp>
+#include <echo/utils/terminal.hpp>
+
+#include <poll.h>
+#include <termios.h>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    constexpr uint64_t STEP_BUDGET = 200000; // Lines examined per move before giving up (keeps keys responsive)
+    constexpr uint64_t SEARCH_CHUNK = 16 << 20; // Bytes searched between checks for Esc
+
+    struct Options {
+        std::vector<std::string> files;
+        bool rotated = false;
+        bool print = false;
+        bool line_numbers = false;
+        std::string grep;
+        echo::ViewFilter filter;
+    };
+
+    void usage() {
+        std::cerr << "usage: echo-view [-r] [-l LEVEL] [-c CATEGORY] [-g TEXT] [-p] [-n] FILE...\n";
+    }
+
+    bool parse_args(int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&](std::string &out) {
+                if (i + 1 >= argc) {
+                    std::cerr << "echo-view: " << arg << " needs a value\n";
+                    return false;
+                }
+                out = argv[++i];
+                return true;
+            };
+            std::string v;
+            if (arg == "-r" || arg == "--rotated") {
+                options.rotated = true;
+            } else if (arg == "-p" || arg == "--print") {
+                options.print = true;
+            } else if (arg == "-n" || arg == "--line-numbers") {
+                options.line_numbers = true;
+            } else if (arg == "-l" || arg == "--level") {
+                if (!value(v)) {
+                    return false;
+                }
+                options.filter.min_level = echo::detail::parse_level_from_string(v.c_str());
+            } else if (arg == "-c" || arg == "--category") {
+                if (!value(options.filter.category)) {
+                    return false;
+                }
+            } else if (arg == "-g" || arg == "--grep") {
+                if (!value(options.grep)) {
+                    return false;
+                }
+            } else if (arg == "-h" || arg == "--help") {
+                usage();
+                std::exit(0);
+            } else if (!arg.empty() && arg[0] == '-') {
+                std::cerr << "echo-view: unknown option " << arg << "\n";
+                return false;
+            } else {
+                options.files.push_back(arg);
+            }
+        }
+        return !options.files.empty();
+    }
+
+    // =================================================================================================
+    // Print mode
+    // =================================================================================================
+
+    void print_line(echo::LogView &view, uint64_t offset, bool line_numbers) {
+        if (line_numbers) {
+            std::printf("%llu:", static_cast<unsigned long long>(*view.line_number(offset) + 1));
+        }
+        std::string_view text = view.line(offset);
+        std::fwrite(text.data(), 1, text.size(), stdout);
+        std::fputc('\n', stdout);
+    }
+
+    int run_print(echo::LogView &view, const Options &options) {
+        if (options.line_numbers) {
+            view.wait_for_index();
+        }
+        if (view.empty()) {
+            return 1;
+        }
+        bool found = false;
+        if (!options.grep.empty()) {
+            // Jump between hits with the SIMD search; only hit lines are parsed
+            uint64_t pos = 0;
+            while (auto hit = view.find(options.grep, pos, true, &options.filter)) {
+                print_line(view, *hit, options.line_numbers);
+                found = true;
+                pos = view.next_line(*hit);
+            }
+        } else {
+            std::optional<uint64_t> offset = 0;
+            if (!options.filter.matches(view.line(0))) {
+                offset = view.step(0, true, options.filter);
+            }
+            for (; offset; offset = view.step(*offset, true, options.filter)) {
+                print_line(view, *offset, options.line_numbers);
+                found = true;
+            }
+        }
+        return found ? 0 : 1;
+    }
+
+    // =================================================================================================
+    // Interactive mode
+    // =================================================================================================
+
+    class RawTerminal {
+      private:
+        termios saved_{};
+        bool active_ = false;
+
+      public:
+        RawTerminal() {
+            if (tcgetattr(STDIN_FILENO, &saved_) != 0) {
+                return;
+            }
+            termios raw = saved_;
+            raw.c_lflag &= static_cast<tcflag_t>(~(ICANON | ECHO | ISIG | IEXTEN));
+            raw.c_iflag &= static_cast<tcflag_t>(~(IXON | ICRNL));
+            raw.c_cc[VMIN] = 0;
+            raw.c_cc[VTIME] = 0;
+            tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+            std::fputs("\033[?1049h\033[?25l", stdout); // Alternate screen, hide cursor
+            std::fflush(stdout);
+            active_ = true;
+        }
+
+        ~RawTerminal() {
+            if (active_) {
+                std::fputs("\033[?25h\033[?1049l", stdout);
+                std::fflush(stdout);
+                tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved_);
+            }
+        }
+
+        RawTerminal(const RawTerminal &) = delete;
+        RawTerminal &operator=(const RawTerminal &) = delete;
+    };
+
+    enum Key : int {
+        KEY_NONE = -1,
+        KEY_UP = 1000,
+        KEY_DOWN,
+        KEY_LEFT,
+        KEY_RIGHT,
+        KEY_PAGE_UP,
+        KEY_PAGE_DOWN,
+        KEY_HOME,
+        KEY_END,
+        KEY_ESCAPE,
+    };
+
+    /// Next key press; bytes of pasted text or escape sequences arriving together are kept for later calls
+    int read_key(int timeout_ms) {
+        static std::string pending;
+        if (pending.empty()) {
+            pollfd pfd{STDIN_FILENO, POLLIN, 0};
+            if (poll(&pfd, 1, timeout_ms) <= 0) {
+                return KEY_NONE;
+            }
+            char buf[256];
+            ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+            if (n <= 0) {
+                return KEY_NONE;
+            }
+            pending.assign(buf, static_cast<size_t>(n));
+        }
+
+        auto take = [&](size_t count, int key) {
+            pending.erase(0, count);
+            return key;
+        };
+        if (pending[0] != '\033') {
+            return take(1, static_cast<unsigned char>(pending[0]));
+        }
+        if (pending.size() < 3 || pending[1] != '[') {
+            return take(1, KEY_ESCAPE);
+        }
+        switch (pending[2]) {
+        case 'A':
+            return take(3, KEY_UP);
+        case 'B':
+            return take(3, KEY_DOWN);
+        case 'C':
+            return take(3, KEY_RIGHT);
+        case 'D':
+            return take(3, KEY_LEFT);
+        case 'H':
+            return take(3, KEY_HOME);
+        case 'F':
+            return take(3, KEY_END);
+        case '5':
+            return take(pending.size() > 3 && pending[3] == '~' ? 4 : 3, KEY_PAGE_UP);
+        case '6':
+            return take(pending.size() > 3 && pending[3] == '~' ? 4 : 3, KEY_PAGE_DOWN);
+        default:
+            return take(3, KEY_NONE);
+        }
+    }
+
+    /// Printable text of a line: ANSI sequences removed, tabs expanded, control bytes shown as '.'
+    std::string display_text(std::string_view line) {
+        std::string out;
+        out.reserve(line.size());
+        for (size_t i = 0; i < line.size(); ++i) {
+            char c = line[i];
+            if (c == '\033' && i + 1 < line.size() && line[i + 1] == '[') {
+                size_t end = line.find_first_of("ABCDEFGHJKSTfmsu", i + 2);
+                i = end == std::string_view::npos ? line.size() : end;
+            } else if (c == '\t') {
+                out.append(4 - out.size() % 4, ' ');
+            } else if (static_cast<unsigned char>(c) < 0x20 || c == 0x7f) {
+                out += '.';
+            } else {
+                out += c;
+            }
+        }
+        return out;
+    }
+
+    class Viewer {
+      private:
+        echo::LogView &view_;
+        echo::ViewFilter filter_;
+        std::string needle_;
+        uint64_t top_ = 0;
+        size_t shift_ = 0;
+        std::string message_;
+
+        // Prompt state: kind is '/', '?', ':' or 'c'; 0 when inactive
+        char prompt_kind_ = 0;
+        std::string prompt_;
+
+        static int rows() { return std::max(2, echo::detail::get_terminal_height()) - 1; }
+        static int columns() { return std::max(20, echo::detail::get_terminal_width()); }
+
+        bool visible(uint64_t offset) const { return filter_.matches(view_.line(offset)); }
+
+        /// Make top_ a visible line (after a filter change or a jump)
+        void settle() {
+            if (view_.empty() || visible(top_)) {
+                return;
+            }
+            if (auto next = view_.step(top_, true, filter_, STEP_BUDGET)) {
+                top_ = *next;
+            } else if (auto prev = view_.step(top_, false, filter_, STEP_BUDGET)) {
+                top_ = *prev;
+            } else {
+                message_ = "no matching lines nearby";
+            }
+        }
+
+        void move(int lines) {
+            bool forward = lines > 0;
+            for (int i = 0; i < std::abs(lines); ++i) {
+                auto next = view_.step(top_, forward, filter_, STEP_BUDGET);
+                if (!next) {
+                    break;
+                }
+                top_ = *next;
+            }
+        }
+
+        void go_end() {
+            top_ = view_.last_line();
+            settle();
+            move(-(rows() - 1));
+        }
+
+        /// Search in chunks, showing progress and polling for Esc / Ctrl-C in between
+        void search(bool forward) {
+            if (needle_.empty()) {
+                message_ = "no search pattern";
+                return;
+            }
+            const uint64_t start = forward ? view_.next_line(top_) : top_;
+            const uint64_t span = std::max<uint64_t>(forward ? view_.size() - std::min(start, view_.size()) : start, 1);
+            auto last_draw = std::chrono::steady_clock::now();
+            uint64_t from = start;
+            while (true) {
+                auto step = view_.find_some(needle_, from, forward, &filter_, SEARCH_CHUNK);
+                if (step.match) {
+                    top_ = *step.match;
+                    return;
+                }
+                if (step.done) {
+                    message_ = "pattern not found: " + needle_;
+                    return;
+                }
+                from = step.resume;
+
+                int key = read_key(0);
+                if (key == KEY_ESCAPE || key == 3) {
+                    message_ = "search cancelled";
+                    return;
+                }
+                auto now = std::chrono::steady_clock::now();
+                if (now - last_draw >= std::chrono::milliseconds(100)) {
+                    uint64_t searched = forward ? from - start : start - from;
+                    message_ = "searching " + std::to_string(searched * 100 / span) + "% (Esc cancels)";
+                    draw();
+                    message_.clear();
+                    last_draw = now;
+                }
+            }
+        }
+
+        void goto_line(const std::string &text) {
+            uint64_t n = std::strtoull(text.c_str(), nullptr, 10);
+            if (n == 0) {
+                return;
+            }
+            if (auto offset = view_.line_offset(n - 1)) {
+                top_ = *offset;
+                settle();
+            } else if (view_.index_complete()) {
+                message_ = "only " + std::to_string(view_.indexed_lines()) + " lines";
+            } else {
+                message_ = "line " + text + " not indexed yet";
+            }
+        }
+
+        void cycle_level() {
+            int level = (static_cast<int>(filter_.min_level) + 1) % (static_cast<int>(echo::Level::Critical) + 1);
+            filter_.min_level = static_cast<echo::Level>(level);
+            settle();
+        }
+
+        void finish_prompt() {
+            char kind = prompt_kind_;
+            prompt_kind_ = 0; // Closed first, so a long search shows its progress in the status bar
+            switch (kind) {
+            case '/':
+            case '?':
+                if (!prompt_.empty()) {
+                    needle_ = prompt_;
+                }
+                search(kind == '/');
+                break;
+            case ':':
+                goto_line(prompt_);
+                break;
+            case 'c':
+                filter_.category = prompt_;
+                settle();
+                break;
+            }
+        }
+
+        void draw_line(std::string &out, uint64_t offset, std::optional<uint64_t> number, int gutter, int width) {
+            std::string_view raw = view_.line(offset);
+            echo::LineInfo info = echo::parse_line(raw);
+
+            if (gutter > 0) {
+                std::string num = number ? std::to_string(*number + 1) : "";
+                out += "\033[90m";
+                size_t digits = static_cast<size_t>(gutter - 1);
+                out.append(digits - std::min(num.size(), digits), ' ');
+                out += num;
+                out += ' ';
+                out += echo::detail::RESET;
+            }
+
+            std::string text = display_text(raw);
+            text = shift_ < text.size() ? text.substr(shift_) : std::string();
+            if (text.size() > static_cast<size_t>(width - gutter)) {
+                text.resize(static_cast<size_t>(width - gutter));
+            }
+
+            const char *color = info.has_level ? echo::detail::level_color(info.level) : "";
+            out += color;
+            size_t pos = 0;
+            if (!needle_.empty()) {
+                for (size_t hit; (hit = text.find(needle_, pos)) != std::string::npos; pos = hit + needle_.size()) {
+                    out.append(text, pos, hit - pos);
+                    out += "\033[7m";
+                    out.append(text, hit, needle_.size());
+                    out += "\033[27m";
+                }
+            }
+            out.append(text, pos, std::string::npos);
+            out += echo::detail::RESET;
+        }
+
+        void draw() {
+            const int height = rows();
+            const int width = columns();
+            std::string out = "\033[H";
+
+            std::optional<uint64_t> number = view_.line_number(top_);
+            int gutter = 0;
+            if (view_.indexed_lines() > 0 || view_.index_complete()) {
+                gutter = static_cast<int>(std::to_string(std::max<uint64_t>(view_.indexed_lines(), 1)).size()) + 1;
+            }
+
+            uint64_t offset = top_;
+            int row = 0;
+            if (!view_.empty() && visible(offset)) {
+                draw_line(out, offset, number, gutter, width);
+                out += "\033[K\r\n";
+                ++row;
+                // Walk forward, counting skipped lines so numbers stay exact without index lookups
+                uint64_t budget = STEP_BUDGET;
+                while (row < height && budget > 0) {
+                    uint64_t next = view_.next_line(offset);
+                    if (next >= view_.size()) {
+                        break;
+                    }
+                    offset = next;
+                    if (number) {
+                        ++*number;
+                    }
+                    --budget;
+                    if (!visible(offset)) {
+                        continue;
+                    }
+                    draw_line(out, offset, number, gutter, width);
+                    out += "\033[K\r\n";
+                    ++row;
+                }
+            }
+            for (; row < height; ++row) {
+                out += "\033[90m~\033[0m\033[K\r\n";
+            }
+
+            // Status bar
+            std::string status;
+            if (prompt_kind_ != 0) {
+                status = (prompt_kind_ == 'c' ? std::string("category: ") : std::string(1, prompt_kind_)) + prompt_;
+            } else {
+                std::string path(view_.path_at(top_));
+                status = " " + path.substr(path.find_last_of('/') + 1);
+                std::optional<uint64_t> top_number = view_.line_number(top_);
+                status += "  line " + (top_number ? std::to_string(*top_number + 1) : std::string("?"));
+                if (view_.index_complete()) {
+                    status += "/" + std::to_string(view_.indexed_lines());
+                }
+                status += "  " + std::to_string(view_.size() ? top_ * 100 / view_.size() : 100) + "%";
+                status += "  level>=" + std::string(echo::detail::level_name(filter_.min_level));
+                if (!filter_.category.empty()) {
+                    status += "  category=" + filter_.category;
+                }
+                if (!view_.index_complete()) {
+                    uint64_t percent = view_.indexed_bytes() * 100 / std::max<uint64_t>(view_.size(), 1);
+                    status += "  indexing " + std::to_string(percent) + "%";
+                }
+                if (!needle_.empty()) {
+                    status += "  /" + needle_;
+                }
+                if (!message_.empty()) {
+                    status += "  -- " + message_;
+                }
+            }
+            if (status.size() > static_cast<size_t>(width)) {
+                status.resize(static_cast<size_t>(width));
+            }
+            status.append(static_cast<size_t>(width) - status.size(), ' ');
+            out += "\033[7m" + status + "\033[0m";
+
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            std::fflush(stdout);
+        }
+
+        /// Handle a key while a prompt is open
+        void prompt_key(int key) {
+            if (key == '\r' || key == '\n') {
+                finish_prompt();
+            } else if (key == KEY_ESCAPE || key == 3) {
+                prompt_kind_ = 0;
+            } else if (key == 127 || key == 8) {
+                if (!prompt_.empty()) {
+                    prompt_.pop_back();
+                }
+            } else if (key >= 0x20 && key < 0x7f) {
+                prompt_ += static_cast<char>(key);
+            }
+        }
+
+      public:
+        Viewer(echo::LogView &view, const Options &options)
+            : view_(view), filter_(options.filter), needle_(options.grep) {
+            settle();
+        }
+
+        void run() {
+            RawTerminal terminal;
+            // Initial --grep search, once keys can cancel it
+            if (!needle_.empty() && !(visible(top_) && view_.line(top_).find(needle_) != std::string_view::npos)) {
+                search(true);
+            }
+            bool was_indexing = true;
+            while (true) {
+                draw();
+                int key = read_key(was_indexing ? 250 : -1);
+                was_indexing = !view_.index_complete();
+                if (key == KEY_NONE) {
+                    continue;
+                }
+                if (prompt_kind_ != 0) {
+                    prompt_key(key);
+                    continue;
+                }
+                message_.clear();
+                const int page = rows() - 1;
+                switch (key) {
+                case 'q':
+                case 3:
+                    return;
+                case 'j':
+                case KEY_DOWN:
+                case '\r':
+                    move(1);
+                    break;
+                case 'k':
+                case KEY_UP:
+                    move(-1);
+                    break;
+                case ' ':
+                case KEY_PAGE_DOWN:
+                    move(page);
+                    break;
+                case 'b':
+                case KEY_PAGE_UP:
+                    move(-page);
+                    break;
+                case 'g':
+                case KEY_HOME:
+                    top_ = 0;
+                    settle();
+                    break;
+                case 'G':
+                case KEY_END:
+                    go_end();
+                    break;
+                case KEY_RIGHT:
+                    shift_ += 8;
+                    break;
+                case KEY_LEFT:
+                    shift_ = shift_ >= 8 ? shift_ - 8 : 0;
+                    break;
+                case 'n':
+                    search(true);
+                    break;
+                case 'N':
+                    search(false);
+                    break;
+                case 'l':
+                    cycle_level();
+                    break;
+                case '/':
+                case '?':
+                case ':':
+                case 'c':
+                    prompt_kind_ = static_cast<char>(key);
+                    prompt_.clear(); // For 'c', an empty entry clears the category
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+    };
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    std::vector<std::string> paths;
+    for (const auto &file : options.files) {
+        if (options.rotated) {
+            auto set = echo::rotation_set(file);
+            paths.insert(paths.end(), set.begin(), set.end());
+        } else {
+            paths.push_back(file);
+        }
+    }
+
+    echo::LogView view;
+    if (!view.open(paths)) {
+        std::cerr << "echo-view: " << view.error() << "\n";
+        return 2;
+    }
+    view.start_indexing();
+
+    if (options.print || !echo::detail::is_stdout_tty() || !isatty(STDIN_FILENO)) {
+        return run_print(view, options);
+    }
+    Viewer(view, options).run();
+    return 0;
+}